@@ -259,11 +259,11 @@ void
 Setup_CapturePlayerInput(SDL_EventKeyFilter& filter)
 {
     filter._callback = nullptr;
-    filter._key_filter.push_back(SDL_SCANCODE_A);
-    filter._key_filter.push_back(SDL_SCANCODE_S);
-    filter._key_filter.push_back(SDL_SCANCODE_D);
-    filter._key_filter.push_back(SDL_SCANCODE_W);
-    filter._key_filter.push_back(SDL_SCANCODE_K);
+    filter._key_filter.set(SDL_SCANCODE_A);
+    filter._key_filter.set(SDL_SCANCODE_S);
+    filter._key_filter.set(SDL_SCANCODE_D);
+    filter._key_filter.set(SDL_SCANCODE_W);
+    filter._key_filter.set(SDL_SCANCODE_K);
 }
 
 
@@ -281,7 +281,7 @@ Setup_CaptureEscapeKey(SDL_EventKeyFilter& filter, bool* running)
 {
     filter._callback = &App_OnKeyEscape;
     filter._userdata = Cast(void*, running);
-    filter._key_filter.push_back(SDL_SCANCODE_ESCAPE);
+    filter._key_filter.set(SDL_SCANCODE_ESCAPE);
 }
 
 
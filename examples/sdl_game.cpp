@@ -1,10 +1,25 @@
+#include "Base/containers/small_vector.h"
+#include "Base/containers/soa_array.h"
 #include "Base/debug_services.h"
+#include "Base/ecs/ecs.h"
+#include "Base/ecs/ecs_commands.h"
+#include "Base/ecs/ecs_dispatch.h"
+#include "Base/ecs/ecs_prefab.h"
+#include "Base/ecs/ecs_scheduler.h"
+#include "Base/ecs/ecs_snapshot.h"
+#include "Base/ecs/ecs_tick_rate.h"
+#include "Base/ecs/ecs_view.h"
+#include "Base/kernels/animation.h"
+#include "Base/kernels/movement.h"
 #include "Base/platform/sdl/sdl_events.h"
 #include "Base/platform/sdl/sdl_window.h"
+#include "Base/spatial_grid.h"
 #include "GeometricAlgebra/geometric_algebra.h"
 #include <SDL2/SDL_image.h>
 #include <algorithm>
 #include <cassert>
+#include <cmath>
+#include <cstring>
 #include <stdio.h>
 
 
@@ -17,55 +32,36 @@ constexpr float const RENDER_PERIOD = 1.0f / RENDER_HZ;
 constexpr float const SIM_HZ        = 60.0f;
 constexpr float const SIM_PERIOD    = 1.0f / SIM_HZ;
 
+// How many simulation steps back a late input can still be corrected.
+constexpr uint32 const ROLLBACK_TICKS = 16;
 
-struct Components
-{
-    Int           entitiy_id;
-    Int           state_idx;
-    Int           input_idx;
-    Int           position_idx;
-    Int           projection_idx;
-    Int           velocity_idx;
-    Int           bounding_box_idx;
-    Array<Int, 8> texture_idx;
-};
+// Entities further than this from the player are simulated at half rate, and
+// each doubling of the distance halves it again, see Sim_TickRatePriority.
+constexpr float const TICK_RATE_DISTANCE = 1024.0f;
 
+// About the size of a bounding box, see SpatialGrid.
+constexpr float const  SPATIAL_CELL_SIZE    = 64.0f;
+constexpr uint32 const SPATIAL_BUCKET_COUNT = 4096;
 
-enum class ComponentId
-{
-    State,
-    Input,
-    Position,
-    Projection,
-    Velocity,
-    BoundingBox,
-    Texture,
-};
+// Deterministic keeps every machine's simulation bit for bit the same.
+constexpr MovementMode const MOVEMENT_MODE       = MovementMode::Deterministic;
+constexpr float const        MOVEMENT_FRICTION   = 0.1f;
+constexpr float const        MOVEMENT_STOP_SPEED = 0.01f;
+constexpr float const        MOVEMENT_SCALE      = 300.0f;
 
 
-int
-BitToIndex(int val, int num_bits = 32)
-{
-    for (int index = 0; index < num_bits; ++index)
-    {
-        auto bit = 1 << index;
-        if (val & bit)
-        {
-            return index;
-        }
-    }
-    return -1;
-}
+using EntityId = EcsEntity;
 
 
-using UpdateStateFunction = void (*)(Components*);
+/// UpdateStateFunction - updates every entity currently in one state, see System_UpdateStates.
+using UpdateStateFunction = void (*)(EcsWorld& world, std::span<EntityId const> entities);
 
 struct StateComponent
 {
     UpdateStateFunction UpdateState;
 
-    Array<Int, 8>   action_texture_map;
-    Array<float, 8> action_timer_map;
+    SmallVector<Int, 8>   action_texture_map;
+    SmallVector<float, 8> action_timer_map;
 
     UInt movement;
 
@@ -99,7 +95,9 @@ struct PositionComponent
 };
 
 
-struct ProjectionComponent
+// The position at the start of the last simulation step. Rendering lerps from
+// it to PositionComponent, so it never has to run the simulation itself.
+struct PreviousPositionComponent
 {
     float x, y;
 };
@@ -107,7 +105,7 @@ struct ProjectionComponent
 
 struct VelocityComponent
 {
-    Vec v;
+    float x, y;
 };
 
 
@@ -119,32 +117,39 @@ struct BoundingBoxComponent
 };
 
 
+// The sprite sheet description, only needed when rendering.
 struct TextureComponent
 {
     SDL_Texture* texture;
-    Int          n_sprites;
     Int          sprite_w;
     Int          sprite_h;
     Int          scale;
     Vec          offset;
     Vec          stride;
+};
 
-    bool  animate;
-    float frame_t;
-    float anim_t;
-    int   frame;
+
+// NOTE: The animation pass only touches the timing fields, so they get their
+// own columns and the sprite sheet description stays out of its cache lines.
+enum TextureField
+{
+    Texture_Sprite,
+    Texture_Animate,
+    Texture_NSprites,
+    Texture_FrameT,
+    Texture_AnimT,
+    Texture_Frame,
+    Texture_Looped,
 };
 
+using TextureTable = SoaArray<32, TextureComponent, bool, Int, float, float, Int, UByte>;
 
-struct EntityComponentSystem
+
+// The rows of the texture table an entity can draw with.
+struct TextureSetComponent
 {
-    Array<StateComponent, 16>       states;
-    Array<PositionComponent, 16>    positions;
-    Array<ProjectionComponent, 16>  projections;
-    Array<VelocityComponent, 16>    velocities;
-    Array<InputComponent, 16>       inputs;
-    Array<BoundingBoxComponent, 16> bounding_boxes;
-    Array<TextureComponent, 32>     textures;
+    SmallVector<Int, 8> texture_idx;
+    Int                 active { -1 }; // The texture to draw, chosen from the state.
 };
 
 
@@ -158,373 +163,436 @@ enum PlayerAction
 
 struct Player
 {
-    Components* components;
+    EntityId entity;
 };
 
 
 struct GameStruct
 {
-    Window                window;
-    SDL_EventQueue        event_q;
-    SDL_EventKeyFilter    filter;
-    SDL_EventKeyFilter    player_input_filter;
-    bool                  running;
-    Array<Components, 16> entities;
-    EntityComponentSystem ecs;
-    Player                player;
+    Window             window;
+    SDL_EventQueue     event_q;
+    SDL_EventKeyFilter filter;
+    SDL_EventKeyFilter player_input_filter;
+    bool               running;
+    EcsWorld           world;
+    TextureTable       textures;
+    Player             player;
+
+    // Systems run once per simulation step, and once per frame.
+    EcsScheduler sim_systems;
+    EcsScheduler frame_systems;
+
+    // Structural changes recorded by the systems, applied once they are done.
+    EcsCommands commands;
+
+    // Every bounding box in the world, by entity index.
+    SpatialGrid         spatial_grid;
+    std::vector<uint32> visible;
+
+    // The world at the start of each of the last ROLLBACK_TICKS steps, see Sim_Rollback.
+    EcsSnapshotRing snapshots;
+    uint64          sim_tick { 0 };
+
+    // Scratch space for moving entities between tick rates, see Sim_Step.
+    EcsTickRates tick_rates;
+
+    // NOTE: Declared after the world so the workers stop before it is destroyed.
+    WorkerPool workers;
 } game_struct;
 
 
 //////////////////////////////////////////////////////////////////////////////
 
 
-UInt
-Component_Reserve(EntityComponentSystem& ecs, ComponentId id)
+/// Texture_Reserve - adds a row to the texture table and returns its index.
+Int
+Texture_Reserve(TextureTable& textures)
 {
-    switch (id)
-    {
-        case ComponentId::State:
-        {
-            ecs.states.reserve(1);
-            return ecs.states.size() - 1;
-        }
-        case ComponentId::Input:
-        {
-            ecs.inputs.reserve(1);
-            return ecs.inputs.size() - 1;
-        }
-        case ComponentId::Position:
-        {
-            ecs.positions.reserve(1);
-            return ecs.positions.size() - 1;
-        }
-        case ComponentId::Projection:
-        {
-            ecs.projections.reserve(1);
-            return ecs.projections.size() - 1;
-        }
-        case ComponentId::Velocity:
-        {
-            ecs.velocities.reserve(1);
-            return ecs.velocities.size() - 1;
-        }
-        case ComponentId::BoundingBox:
-        {
-            ecs.bounding_boxes.reserve(1);
-            return ecs.bounding_boxes.size() - 1;
-        }
-        case ComponentId::Texture:
-        {
-            ecs.textures.reserve(1);
-            return ecs.textures.size() - 1;
-        }
-    }
+    [[maybe_unused]] bool reserved = textures.reserve(1);
+    assert(reserved);
+    return Cast(Int, textures.size() - 1);
 }
 
 
 //////////////////////////////////////////////////////////////////////////////
 
 
+/// System_UpdateMovement - moves the entities of each tick rate due on step,
+/// by the time since they last moved.
 void
-System_UpdateMovement(EntityComponentSystem& ecs,
-                      Components*            components,
-                      float                  dt,
-                      bool                   update_projection = false)
+System_UpdateMovement(EcsWorld& world, uint64 step)
 {
-    StateComponent*      state      = nullptr;
-    InputComponent*      input      = nullptr;
-    PositionComponent*   position   = nullptr;
-    ProjectionComponent* projection = nullptr;
-    VelocityComponent*   velocity   = nullptr;
-
-    InputComponent    default_input { 0, 0 };
-    VelocityComponent default_velocity { 0, 0 };
-
-    if (components->state_idx >= 0)
-    {
-        state = &ecs.states[components->state_idx];
-    }
-
-    if (components->input_idx >= 0)
-    {
-        input = &ecs.inputs[components->input_idx];
-    }
-    else
+    // NOTE: Each step is its own pass over the archetypes that have the
+    // components it needs, so none of the loops check for optional components.
+    static auto steer_views = EcsTickRate_MakeViews<VelocityComponent, InputComponent const>();
+    static auto state_views = EcsTickRate_MakeViews<StateComponent, VelocityComponent const>();
+    static auto previous_views
+        = EcsTickRate_MakeViews<PreviousPositionComponent, PositionComponent const>();
+    static auto integrate_views = EcsTickRate_MakeViews<PositionComponent, VelocityComponent>();
+
+    // Input overrides the velocity while it is held.
+    auto steer = [](VelocityComponent& velocity, InputComponent const& input) {
+        if (Vec_Magnitude(input.movement) > 0.5)
+        {
+            velocity.x = input.movement.x;
+            velocity.y = input.movement.y;
+        }
+    };
+
+    auto classify = [](StateComponent& state, VelocityComponent const& velocity) {
+        state.movement = Vec_Magnitude(Vec { velocity.x, velocity.y }) > 0.01 ? 1 : 0;
+    };
+
+    // Keep where everything was before it moves, a column at a time.
+    static_assert(sizeof(PreviousPositionComponent) == sizeof(PositionComponent));
+    auto keep_previous = [](EcsChunk&,
+                            std::span<PreviousPositionComponent> previous,
+                            std::span<PositionComponent const>   positions) {
+        std::memcpy(previous.data(), positions.data(), positions.size_bytes());
+    };
+
+    // Friction and integration run a chunk at a time through the movement
+    // kernel, which reads the x, y pairs of the columns directly.
+    static_assert(sizeof(PositionComponent) == 2 * sizeof(float));
+    static_assert(sizeof(VelocityComponent) == 2 * sizeof(float));
+
+    MovementParams const step_params { MOVEMENT_FRICTION,
+                                       MOVEMENT_STOP_SPEED,
+                                       MOVEMENT_SCALE,
+                                       SIM_PERIOD };
+
+    for (uint32 level = 0; level < ECS_TICK_RATE_LEVELS; ++level)
     {
-        input = &default_input;
-    }
+        if (!EcsTickRate_Due(step, level))
+        {
+            continue;
+        }
 
-    // Must have a position.
-    assert(components->position_idx >= 0);
-    {
-        position = &ecs.positions[components->position_idx];
+        // NOTE: A level that skips steps covers all of them at once.
+        MovementParams const params = Movement_ParamsForSteps(step_params,
+                                                              EcsTickRate_Period(level));
+
+        auto integrate = [&params](EcsChunk&                    chunk,
+                                   std::span<PositionComponent> positions,
+                                   std::span<VelocityComponent> velocities) {
+            Movement_Integrate(&positions[0].x,
+                               &velocities[0].x,
+                               chunk.count,
+                               params,
+                               MOVEMENT_MODE);
+        };
+
+        steer_views[level].each(world, steer);
+        state_views[level].each(world, classify);
+        previous_views[level].each_chunk(world, keep_previous);
+        integrate_views[level].each_chunk(world, integrate);
     }
+}
 
-    bool is_moving = false;
-    if (components->velocity_idx >= 0)
-    {
-        velocity = &ecs.velocities[components->velocity_idx];
-        if (Vec_Magnitude(input->movement) > 0.5)
-        {
-            velocity->v = input->movement;
-        }
 
-        float const friction = 0.1;
-        if (Vec_Magnitude(velocity->v) > 0.01)
-        {
-            is_moving = true;
+/// System_UpdateSpatialGrid - moves the bounding boxes of the entities that
+/// moved, or whose box changed, since the last call.
+void
+System_UpdateSpatialGrid(EcsWorld& world, SpatialGrid& grid)
+{
+    using GridView = EcsView<BoundingBoxComponent const, PositionComponent const>;
 
-            auto opposite = Vec_Normalise(velocity->v) * -1.0f;
-            opposite *= friction;
+    static GridView grid_view;
 
-            velocity->v += opposite;
-        }
-        else
+    auto update = [&grid](EcsChunk&                             chunk,
+                          std::span<BoundingBoxComponent const> boxes,
+                          std::span<PositionComponent const>    positions) {
+        auto entities = EcsChunk_Entities(chunk);
+        for (uint32 row = 0; row < chunk.count; ++row)
         {
-            velocity->v.x = 0;
-            velocity->v.y = 0;
+            auto const& bb = boxes[row];
+            float       x  = positions[row].x + Cast(float, bb.offset.x);
+            float       y  = positions[row].y + Cast(float, bb.offset.y);
+            SpatialBox  box { x, y, x + Cast(float, bb.size.x), y + Cast(float, bb.size.y) };
+            SpatialGrid_Update(grid, entities[row].index, box);
         }
-    }
-    else
-    {
-        velocity = &default_velocity;
-    }
-
-    if (state)
-    {
-        state->movement = is_moving ? 1 : 0;
-    }
-
-    float x_dot = position->x + ((300.0f * velocity->v.x) * dt);
-    float y_dot = position->y + ((300.0f * velocity->v.y) * dt);
-
-    if (update_projection && components->projection_idx >= 0)
-    {
-        projection    = &ecs.projections[components->projection_idx];
-        projection->x = x_dot;
-        projection->y = y_dot;
-    }
-    else
-    {
-        position->x = x_dot;
-        position->y = y_dot;
-    }
+    };
+    grid_view.each_chunk_changed(world, update);
 }
 
 
+/// System_UpdateActionTimers - runs down the action timers by sim_t, ending
+/// the actions whose time is up.
 void
-System_AnimateTextures(EntityComponentSystem& ecs, float sim_t)
+System_UpdateActionTimers(EcsWorld& world, float sim_t)
 {
-    TIME_BLOCK;
-
-    for (auto& state : ecs.states)
-    {
+    Ecs_Each<StateComponent>(world, [&](StateComponent& state) {
         if (state.action != 0)
         {
-            if (state.action_timer >= 0)
-            {
-                state.action_timer -= sim_t;
-            }
+            state.action_timer -= sim_t;
             if (state.action_timer < 0)
             {
-                SDL_Log("ending action\n");
                 state.action = 0;
                 state.queue.pop_front(0);
             }
         }
-    }
+    });
+}
 
-    for (auto& texture : ecs.textures)
-    {
-        if (!texture.animate)
+
+/// System_AnimateTextures - moves every animating texture on by sim_t.
+void
+System_AnimateTextures(TextureTable& textures, float sim_t)
+{
+    TIME_BLOCK;
+
+    AnimationColumns columns { textures.column<Texture_Animate>().data(),
+                               textures.column<Texture_NSprites>().data(),
+                               textures.column<Texture_FrameT>().data(),
+                               textures.column<Texture_AnimT>().data(),
+                               textures.column<Texture_Frame>().data(),
+                               textures.column<Texture_Looped>().data(),
+                               textures.size() };
+    Animation_Advance(columns, sim_t);
+}
+
+
+/// System_SelectTextures - picks the texture to draw for each entity and only
+/// animates that one, for the entities whose state changed since the last call.
+void
+System_SelectTextures(EcsWorld& world, TextureTable& textures)
+{
+    using SelectView = EcsView<TextureSetComponent, StateComponent const>;
+
+    static SelectView select_view;
+
+    auto animate = textures.column<Texture_Animate>();
+    auto select  = [&](TextureSetComponent& texture_set, StateComponent const& state) {
+        if (state.action != PlayerAction::None)
         {
-            texture.frame  = 0;
-            texture.anim_t = 0;
-            continue;
+            texture_set.active = state.action_texture_map[Bits_IndexOfFirstSet(state.action)];
+        }
+        else
+        {
+            texture_set.active = texture_set.texture_idx[state.movement ? 1 : 0];
         }
 
-        texture.anim_t += sim_t;
-        while (texture.anim_t > texture.frame_t)
+        for (auto texture_idx : texture_set.texture_idx)
         {
-            texture.anim_t -= texture.frame_t;
-            texture.frame += 1;
-            if (texture.frame >= texture.n_sprites)
-            {
-                texture.frame = 0;
-            }
+            animate[texture_idx] = false;
         }
-    }
+        animate[texture_set.active] = true;
+    };
+    select_view.each_changed(world, select);
 }
 
 
+/// System_UpdateStates - buckets the entities by their state's handler, then calls
+/// each handler once with all of the entities in that state.
 void
-System_UpdateStates()
+System_UpdateStates(EcsWorld& world)
 {
-    // TODO(DW): need a way of iterating over the entities in the game.
-    // for (auto& state : game_struct.ecs.states)
-    // {
-    //     if (state.UpdateState)
-    //     {
-    //     }
-    // }
-    auto& state = game_struct.ecs.states[game_struct.player.components->state_idx];
-    if (state.UpdateState)
-    {
-        state.UpdateState(game_struct.player.components);
-    }
+    static EcsView<StateComponent const>    state_view;
+    static EcsDispatch<UpdateStateFunction> dispatch;
+
+    dispatch.clear();
+    state_view.each_chunk(world, [](EcsChunk& chunk, std::span<StateComponent const> states) {
+        auto entities = EcsChunk_Entities(chunk);
+        for (uint32 row = 0; row < chunk.count; ++row)
+        {
+            if (states[row].UpdateState)
+            {
+                dispatch.add(states[row].UpdateState, entities[row]);
+            }
+        }
+    });
+
+    dispatch.run([&](UpdateStateFunction update_state, std::span<EntityId const> entities) {
+        update_state(world, entities);
+    });
 }
 
 
 void
-System_UpdateInputQueues()
+System_UpdateInputQueues(EcsWorld& world)
 {
-    for (auto& input : game_struct.ecs.inputs)
-    {
+    Ecs_Each<InputComponent>(world, [](InputComponent& input) {
         std::shift_right(input.queue.begin(), input.queue.end(), 1);
         input.queue[0] = InputActions::None;
-    }
+    });
 }
 
 
-//////////////////////////////////////////////////////////////////////////////
-Int
-Entity_Reserve()
+/// Setup_Systems - declares what each system reads and writes so the scheduler
+/// can run those that don't conflict at the same time.
+void
+Setup_Systems(GameStruct& game)
 {
-    game_struct.entities.reserve(1);
+    EcsSystemFunction action_timers = [](EcsWorld& world, float dt, void*) {
+        System_UpdateActionTimers(world, dt);
+    };
+    EcsSystemFunction movement = [](EcsWorld& world, float, void* sim_tick) {
+        System_UpdateMovement(world, *Cast(uint64*, sim_tick));
+    };
+    EcsSystemFunction states = [](EcsWorld& world, float, void*) {
+        System_UpdateStates(world);
+    };
+    EcsSystemFunction input_queues = [](EcsWorld& world, float, void*) {
+        System_UpdateInputQueues(world);
+    };
+    EcsSystemFunction spatial_grid = [](EcsWorld& world, float, void* grid) {
+        System_UpdateSpatialGrid(world, *Cast(SpatialGrid*, grid));
+    };
+    EcsSystemFunction animate_textures = [](EcsWorld&, float dt, void* textures) {
+        System_AnimateTextures(*Cast(TextureTable*, textures), dt);
+    };
+
+    // NOTE: The timers are part of the simulation, so a rollback replays them.
+    // They run first, so an action started on a step is drawn before any of
+    // its time is taken off.
+    EcsScheduler_Add(game.sim_systems,
+                     EcsSystem_Make<StateComponent>("action timers", action_timers));
+    EcsScheduler_Add(game.sim_systems,
+                     EcsSystem_Make<VelocityComponent,
+                                    StateComponent,
+                                    PositionComponent,
+                                    PreviousPositionComponent,
+                                    InputComponent const>("movement",
+                                                          movement,
+                                                          &game.sim_tick));
+
+    // NOTE: Player_UpdateStates reads the input through Ecs_Get.
+    EcsScheduler_Add(game.sim_systems,
+                     EcsSystem_Make<StateComponent, InputComponent const>("states", states));
+    EcsScheduler_Add(game.sim_systems,
+                     EcsSystem_Make<InputComponent>("input queues", input_queues));
+
+    // NOTE: Added after movement, so it sees this step's positions.
+    SpatialGrid_Init(game.spatial_grid, SPATIAL_CELL_SIZE, SPATIAL_BUCKET_COUNT);
+    EcsScheduler_Add(game.sim_systems,
+                     EcsSystem_Make<BoundingBoxComponent const,
+                                    PositionComponent const>("spatial grid",
+                                                             spatial_grid,
+                                                             &game.spatial_grid));
+
+    // NOTE: Only touches the texture table, not the world.
+    EcsScheduler_Add(game.frame_systems,
+                     EcsSystem_Make<>("animate textures", animate_textures, &game.textures));
+}
 
-    Int id = game_struct.entities.size();
 
-    game_struct.entities.back().entitiy_id = id;
-    return id;
-}
+//////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////
 
-Components&
-Entity_Get(Int id)
+void
+Texture_InitAnimation(TextureTable::Row texture, Int n_sprites, float frame_t)
 {
-    // TODO: Should really search for the id.
-    return game_struct.entities[id - 1];
+    texture.get<Texture_Animate>()  = false;
+    texture.get<Texture_NSprites>() = n_sprites;
+    texture.get<Texture_FrameT>()   = frame_t;
+    texture.get<Texture_AnimT>()    = 0;
+    texture.get<Texture_Frame>()    = 0;
+    texture.get<Texture_Looped>()   = 0;
 }
 
-//////////////////////////////////////////////////////////////////////////////
-
 void
-Player_UpdateState(Components* components);
+Player_UpdateStates(EcsWorld& world, std::span<EntityId const> entities);
 
 void
-Player_Init(Player& player, EntityComponentSystem& ecs)
+Player_Init(Player& player, EcsWorld& world, TextureTable& textures)
 {
-    int         player_id  = Entity_Reserve();
-    Components& components = Entity_Get(player_id);
-
-
-    player.components                 = &components;
-    player.components->state_idx      = Component_Reserve(ecs, ComponentId::State);
-    player.components->input_idx      = Component_Reserve(ecs, ComponentId::Input);
-    player.components->position_idx   = Component_Reserve(ecs, ComponentId::Position);
-    player.components->projection_idx = Component_Reserve(ecs, ComponentId::Projection);
-    player.components->velocity_idx   = Component_Reserve(ecs, ComponentId::Velocity);
-    int texture_idx_1                 = Component_Reserve(ecs, ComponentId::Texture);
-    int texture_idx_2                 = Component_Reserve(ecs, ComponentId::Texture);
-    int texture_idx_3                 = Component_Reserve(ecs, ComponentId::Texture);
-    int texture_idx_4                 = Component_Reserve(ecs, ComponentId::Texture);
-    int texture_idx_5                 = Component_Reserve(ecs, ComponentId::Texture);
-    player.components->texture_idx.push_back(texture_idx_1);
-    player.components->texture_idx.push_back(texture_idx_2);
-    player.components->texture_idx.push_back(texture_idx_3);
-    player.components->texture_idx.push_back(texture_idx_4);
-    player.components->texture_idx.push_back(texture_idx_5);
-
-    StateComponent& state         = ecs.states[player.components->position_idx];
-    state.UpdateState             = &Player_UpdateState;
-    state.movement                = 0;
-    state.action_texture_map[0]   = texture_idx_3;
-    state.action_texture_map[1]   = texture_idx_4;
-    state.action_texture_map[2]   = texture_idx_5;
-    state.action_texture_map.last = 4;
-    state.action_timer_map[0]     = 0.1f * 6;
-    state.action_timer_map[1]     = 0.1f * 6;
-    state.action_timer_map[2]     = 0.1f * 5;
-    state.action_timer_map.last   = 4;
-
-    InputComponent& input = ecs.inputs[player.components->input_idx];
+    int texture_idx_1 = Texture_Reserve(textures);
+    int texture_idx_2 = Texture_Reserve(textures);
+    int texture_idx_3 = Texture_Reserve(textures);
+    int texture_idx_4 = Texture_Reserve(textures);
+    int texture_idx_5 = Texture_Reserve(textures);
+
+    // NOTE: The player's components are set up in a prefab, so the entity is
+    // created with them in one go rather than filled in a component at a time.
+    EcsPrefab prefab;
+
+    TextureSetComponent& texture_set = *EcsPrefab_Set(prefab, TextureSetComponent {});
+    texture_set.texture_idx.push_back(texture_idx_1);
+    texture_set.texture_idx.push_back(texture_idx_2);
+    texture_set.texture_idx.push_back(texture_idx_3);
+    texture_set.texture_idx.push_back(texture_idx_4);
+    texture_set.texture_idx.push_back(texture_idx_5);
+
+    StateComponent& state = *EcsPrefab_Set(prefab, StateComponent {});
+    state.UpdateState     = &Player_UpdateStates;
+    state.movement        = 0;
+    state.action_texture_map.push_back(texture_idx_3);
+    state.action_texture_map.push_back(texture_idx_4);
+    state.action_texture_map.push_back(texture_idx_5);
+    state.action_timer_map.push_back(0.1f * 6);
+    state.action_timer_map.push_back(0.1f * 6);
+    state.action_timer_map.push_back(0.1f * 5);
+
+    InputComponent& input = *EcsPrefab_Set(prefab, InputComponent {});
     input.movement        = { 0, 0 };
     input.queue.reserve_all();
 
-    PositionComponent& position = ecs.positions[player.components->position_idx];
-    position.x                  = 0;
-    position.y                  = 0;
-
-    TextureComponent& texture_idle = ecs.textures[player.components->texture_idx[0]];
-    texture_idle.n_sprites         = 1;
-    texture_idle.sprite_w          = 128;
-    texture_idle.sprite_h          = 64;
-    texture_idle.scale             = 3;
-    texture_idle.stride            = { 0, 64 };
-    texture_idle.frame_t           = 0.1;
-    texture_idle.anim_t            = 0;
-    texture_idle.frame             = 0;
-    texture_idle.texture           = IMG_LoadTexture(game_struct.window.renderer.renderer,
-                                           "Hero/Sprites/Idle.png");
-    assert(texture_idle.texture != nullptr);
-
-    TextureComponent& texture_run = ecs.textures[player.components->texture_idx[1]];
-    texture_run.n_sprites         = 6;
-    texture_run.sprite_w          = 128;
-    texture_run.sprite_h          = 64;
-    texture_run.scale             = 3;
-    texture_run.stride            = { 0, 64 };
-    texture_run.frame_t           = 0.1;
-    texture_run.anim_t            = 0;
-    texture_run.frame             = 0;
-    texture_run.texture           = IMG_LoadTexture(game_struct.window.renderer.renderer,
-                                          "Hero/Sprites/Run & Hop.png");
-    assert(texture_run.texture != nullptr);
+    EcsPrefab_Set(prefab, PositionComponent { 0, 0 });
+    EcsPrefab_Add<PreviousPositionComponent>(prefab);
+    EcsPrefab_Add<VelocityComponent>(prefab);
+
+    auto              texture_idle = textures[texture_idx_1];
+    TextureComponent& sprite_idle  = texture_idle.get<Texture_Sprite>();
+    sprite_idle.sprite_w           = 128;
+    sprite_idle.sprite_h           = 64;
+    sprite_idle.scale              = 3;
+    sprite_idle.stride             = { 0, 64 };
+    sprite_idle.texture            = IMG_LoadTexture(game_struct.window.renderer.renderer,
+                                          "Hero/Sprites/Idle.png");
+    assert(sprite_idle.texture != nullptr);
+    Texture_InitAnimation(texture_idle, 1, 0.1);
+
+    auto              texture_run = textures[texture_idx_2];
+    TextureComponent& sprite_run  = texture_run.get<Texture_Sprite>();
+    sprite_run.sprite_w           = 128;
+    sprite_run.sprite_h           = 64;
+    sprite_run.scale              = 3;
+    sprite_run.stride             = { 0, 64 };
+    sprite_run.texture            = IMG_LoadTexture(game_struct.window.renderer.renderer,
+                                         "Hero/Sprites/Run & Hop.png");
+    assert(sprite_run.texture != nullptr);
+    Texture_InitAnimation(texture_run, 6, 0.1);
 
     // TODO(DW): Order - needs reference to texture_run.
-    BoundingBoxComponent& bb = ecs.bounding_boxes[player.components->bounding_box_idx];
-    bb.offset                = { 50.0f * texture_run.scale, 35.0f * texture_run.scale };
-    bb.size                  = { 8.0f * texture_run.scale, 12.0f * texture_run.scale };
-
-    TextureComponent& texture_attack_1 = ecs.textures[player.components->texture_idx[2]];
-    texture_attack_1.n_sprites         = 6;
-    texture_attack_1.sprite_w          = 128;
-    texture_attack_1.sprite_h          = 64;
-    texture_attack_1.scale             = 3;
-    texture_attack_1.offset            = { 0, 0 };
-    texture_attack_1.stride            = { 0, 64 };
-    texture_attack_1.frame_t           = 0.1;
-    texture_attack_1.anim_t            = 0;
-    texture_attack_1.frame             = 0;
-    texture_attack_1.texture           = IMG_LoadTexture(game_struct.window.renderer.renderer,
-                                               "Hero/Sprites/Chain Attack.png");
-    assert(texture_attack_1.texture != nullptr);
-
-    TextureComponent& texture_attack_2 = ecs.textures[player.components->texture_idx[3]];
-    texture_attack_2.n_sprites         = 6;
-    texture_attack_2.sprite_w          = 128;
-    texture_attack_2.sprite_h          = 64;
-    texture_attack_2.scale             = 3;
-    texture_attack_2.offset            = { 0, 6 * 64 };
-    texture_attack_2.stride            = { 0, 64 };
-    // Note(DW): The queue gets shifted
-    texture_attack_2.frame_t = 0.1;
-    texture_attack_2.anim_t  = 0;
-    texture_attack_2.frame   = 0;
-    texture_attack_2.texture = texture_attack_1.texture;
-    assert(texture_attack_2.texture != nullptr);
-
-    TextureComponent& texture_attack_3 = ecs.textures[player.components->texture_idx[4]];
-    texture_attack_3.n_sprites         = 6;
-    texture_attack_3.sprite_w          = 128;
-    texture_attack_3.sprite_h          = 64;
-    texture_attack_3.scale             = 3;
-    texture_attack_3.offset            = { 0, 12 * 64 };
-    texture_attack_3.stride            = { 0, 64 };
-    texture_attack_3.frame_t           = 0.1;
-    texture_attack_3.anim_t            = 0;
-    texture_attack_3.frame             = 0;
-    texture_attack_3.texture           = texture_attack_1.texture;
-    assert(texture_attack_3.texture != nullptr);
+    BoundingBoxComponent& bb = *EcsPrefab_Set(prefab, BoundingBoxComponent {});
+    bb.offset                = { 50.0f * sprite_run.scale, 35.0f * sprite_run.scale };
+    bb.size                  = { 8.0f * sprite_run.scale, 12.0f * sprite_run.scale };
+
+    auto              texture_attack_1 = textures[texture_idx_3];
+    TextureComponent& sprite_attack_1  = texture_attack_1.get<Texture_Sprite>();
+    sprite_attack_1.sprite_w           = 128;
+    sprite_attack_1.sprite_h           = 64;
+    sprite_attack_1.scale              = 3;
+    sprite_attack_1.offset             = { 0, 0 };
+    sprite_attack_1.stride             = { 0, 64 };
+    sprite_attack_1.texture            = IMG_LoadTexture(game_struct.window.renderer.renderer,
+                                              "Hero/Sprites/Chain Attack.png");
+    assert(sprite_attack_1.texture != nullptr);
+    Texture_InitAnimation(texture_attack_1, 6, 0.1);
+
+    auto              texture_attack_2 = textures[texture_idx_4];
+    TextureComponent& sprite_attack_2  = texture_attack_2.get<Texture_Sprite>();
+    sprite_attack_2.sprite_w           = 128;
+    sprite_attack_2.sprite_h           = 64;
+    sprite_attack_2.scale              = 3;
+    sprite_attack_2.offset             = { 0, 6 * 64 };
+    sprite_attack_2.stride             = { 0, 64 };
+    sprite_attack_2.texture            = sprite_attack_1.texture;
+    assert(sprite_attack_2.texture != nullptr);
+    Texture_InitAnimation(texture_attack_2, 6, 0.1);
+
+    auto              texture_attack_3 = textures[texture_idx_5];
+    TextureComponent& sprite_attack_3  = texture_attack_3.get<Texture_Sprite>();
+    sprite_attack_3.sprite_w           = 128;
+    sprite_attack_3.sprite_h           = 64;
+    sprite_attack_3.scale              = 3;
+    sprite_attack_3.offset             = { 0, 12 * 64 };
+    sprite_attack_3.stride             = { 0, 64 };
+    sprite_attack_3.texture            = sprite_attack_1.texture;
+    assert(sprite_attack_3.texture != nullptr);
+    Texture_InitAnimation(texture_attack_3, 6, 0.1);
+
+    EcsPrefab_Instantiate(world, prefab, { &player.entity, 1 });
 }
 
 
@@ -623,7 +691,7 @@ Player_OnUpdateInput(Array<SDL_Event, SDL_EVENTQUEUESIZE>& events, void* _)
         }
     }
     auto& player = game_struct.player;
-    auto& input  = game_struct.ecs.inputs[player.components->input_idx];
+    auto& input  = *Ecs_Get<InputComponent>(game_struct.world, player.entity);
 
     auto lr          = d - a;
     auto ud          = s - w;
@@ -648,63 +716,174 @@ Player_OnUpdateInput(Array<SDL_Event, SDL_EVENTQUEUESIZE>& events, void* _)
 
 
 void
-Player_UpdateState(Components* components)
+Player_UpdateStates(EcsWorld& world, std::span<EntityId const> entities)
 {
-    // TODO: This is very specific to the player.
-    assert(components->input_idx >= 0);
-    assert(components->state_idx >= 0);
+    for (EntityId entity : entities)
+    {
+        // TODO: This is very specific to the player.
+        assert(Ecs_Has<InputComponent>(world, entity));
+        assert(Ecs_Has<StateComponent>(world, entity));
 
-    auto& input = game_struct.ecs.inputs[components->input_idx];
-    auto& state = game_struct.ecs.states[components->state_idx];
+        auto& input = *Ecs_Get<InputComponent const>(world, entity);
+        auto& state = *Ecs_Get<StateComponent>(world, entity);
 
-    auto region_1 = input.queue.begin();
-    auto region_2 = input.queue.begin() + 1;
-    auto region_3 = input.queue.begin() + 38;
-    auto region_4 = input.queue.begin() + 64;
+        auto region_1 = input.queue.begin();
+        auto region_2 = input.queue.begin() + 1;
+        auto region_3 = input.queue.begin() + 38;
+        auto region_4 = input.queue.begin() + 64;
 
-    {
-        auto i1 = std::count(region_1, region_2, InputActions::Attack);
-        auto i2 = std::count(region_2, region_3, InputActions::Attack);
-        auto i3 = std::count(region_3, region_4, InputActions::Attack);
-
-        if (i1 == 1 && i2 == 1 && i3 == 1)
         {
-            if (std::count(state.queue.begin(), state.queue.end(), PlayerAction::Attack_3) == 0)
+            auto i1 = std::count(region_1, region_2, InputActions::Attack);
+            auto i2 = std::count(region_2, region_3, InputActions::Attack);
+            auto i3 = std::count(region_3, region_4, InputActions::Attack);
+
+            if (i1 == 1 && i2 == 1 && i3 == 1)
             {
-                SDL_Log("Attack 3");
-                state.queue.push_back(PlayerAction::Attack_3);
+                if (std::count(state.queue.begin(), state.queue.end(), PlayerAction::Attack_3) == 0)
+                {
+                    SDL_Log("Attack 3");
+                    state.queue.push_back(PlayerAction::Attack_3);
+                }
             }
-        }
-        else if (i1 == 1 && i2 == 1)
-        {
-            if (std::count(state.queue.begin(), state.queue.end(), PlayerAction::Attack_2) == 0)
+            else if (i1 == 1 && i2 == 1)
             {
-                SDL_Log("Attack 2");
-                state.queue.push_back(PlayerAction::Attack_2);
+                if (std::count(state.queue.begin(), state.queue.end(), PlayerAction::Attack_2) == 0)
+                {
+                    SDL_Log("Attack 2");
+                    state.queue.push_back(PlayerAction::Attack_2);
+                }
             }
-        }
-        else if (i1 == 1)
-        {
-            if (std::count(state.queue.begin(), state.queue.end(), PlayerAction::Attack_1) == 0)
+            else if (i1 == 1)
             {
-                SDL_Log("Attack 1");
-                state.queue.push_back(PlayerAction::Attack_1);
+                if (std::count(state.queue.begin(), state.queue.end(), PlayerAction::Attack_1) == 0)
+                {
+                    SDL_Log("Attack 1");
+                    state.queue.push_back(PlayerAction::Attack_1);
+                }
             }
         }
+
+
+        if ((state.action == PlayerAction::None) && (state.queue.size() > 0))
+        {
+            // Note(DW): The item gets popped when the timer expires.
+            state.action       = state.queue[0];
+            Int index          = Bits_IndexOfFirstSet(state.action);
+            state.action_timer = state.action_timer_map[index];
+        }
+    }
+}
+
+
+//////////////////////////////////////////////////////////////////////////////
+
+
+/// Sim_TickRatePriority - full rate near the player, then half the rate for
+/// every doubling of the distance past TICK_RATE_DISTANCE, and at most half
+/// rate for anything at rest. Whatever takes input stays at full rate.
+void
+Sim_TickRatePriority(EcsWorld&           world,
+                     EcsArchetype const& archetype,
+                     EcsChunk&           chunk,
+                     std::span<uint8>    levels,
+                     void*               userdata)
+{
+    if (EcsArchetype_Has(archetype, Ecs_TypeId<InputComponent>()))
+    {
+        return;
     }
 
+    auto const& game   = *Cast(GameStruct const*, userdata);
+    auto const* player = Ecs_Get<PositionComponent const>(world, game.player.entity);
+    float       px     = player ? player->x : 0.0f;
+    float       py     = player ? player->y : 0.0f;
 
-    if ((state.action == PlayerAction::None) && (state.queue.size() > 0))
+    auto positions  = EcsChunk_Column<PositionComponent>(archetype, chunk);
+    auto velocities = EcsChunk_Column<VelocityComponent>(archetype, chunk);
+    for (uint32 row = 0; row < chunk.count; ++row)
     {
-        // Note(DW): The item gets popped when the timer expires.
-        state.action       = state.queue[0];
-        Int index          = BitToIndex(state.action);
-        state.action_timer = state.action_timer_map[index];
+        float dx       = positions[row].x - px;
+        float dy       = positions[row].y - py;
+        float distance = std::sqrt((dx * dx) + (dy * dy));
+
+        uint32 level = 0;
+        for (float far = TICK_RATE_DISTANCE; distance > far && level + 1 < ECS_TICK_RATE_LEVELS;
+             far *= 2.0f)
+        {
+            level += 1;
+        }
+
+        float vx = velocities[row].x;
+        float vy = velocities[row].y;
+        if (level == 0 && ((vx * vx) + (vy * vy)) < (MOVEMENT_STOP_SPEED * MOVEMENT_STOP_SPEED))
+        {
+            level = 1;
+        }
+        levels[row] = Cast(uint8, level);
     }
 }
 
 
-//////////////////////////////////////////////////////////////////////////////
+/// Sim_Step - runs one simulation step, snapshotting the world first so the
+/// step can be run again by Sim_Rollback. Doesn't touch the window or renderer.
+void
+Sim_Step(GameStruct& game)
+{
+    EcsSnapshotRing_Save(game.snapshots, game.world, game.sim_tick);
+
+    // NOTE: Only on sync steps, where every tick rate has just been updated,
+    // so an entity changing rate is never owed or given extra time.
+    if (EcsTickRate_IsSync(game.sim_tick))
+    {
+        EcsTickRates_Assign(game.tick_rates,
+                            game.world,
+                            Ecs_Mask<PositionComponent, VelocityComponent>(),
+                            &Sim_TickRatePriority,
+                            &game);
+    }
+    EcsScheduler_Run(game.sim_systems, game.world, SIM_PERIOD, &game.workers);
+    Ecs_ApplyCommands(game.world, game.commands);
+    game.sim_tick += 1;
+}
+
+
+/// CorrectInputFunction - replaces the input of the step about to be re-run, see Sim_Rollback.
+using CorrectInputFunction = void (*)(EcsWorld& world, uint64 tick, void* userdata);
+
+/// Sim_Rollback - puts the world back the way it was at the start of tick and
+/// runs every step since again, calling correct_input before each of them.
+/// Returns false, leaving the world alone, if tick is too far back.
+///
+/// NOTE: Only the world is rolled back, which holds everything the sim systems
+/// change, action timers included. The texture table isn't, so animations carry
+/// on from where they were, and the spatial grid is rebuilt from the world.
+bool
+Sim_Rollback(GameStruct& game, uint64 tick, CorrectInputFunction correct_input, void* userdata)
+{
+    EcsSnapshot const* snapshot = EcsSnapshotRing_Find(game.snapshots, tick);
+    if (!snapshot || tick >= game.sim_tick)
+    {
+        return false;
+    }
+
+    TIME_BLOCK;
+
+    uint64 now = game.sim_tick;
+    Ecs_LoadSnapshot(game.world, *snapshot);
+    SpatialGrid_Clear(game.spatial_grid);
+
+    // NOTE: Each step saves over the snapshot it started from with what should
+    // be an equal copy, except where the input was corrected.
+    for (game.sim_tick = tick; game.sim_tick < now;)
+    {
+        if (correct_input)
+        {
+            correct_input(game.world, game.sim_tick, userdata);
+        }
+        Sim_Step(game);
+    }
+    return true;
+}
 
 
 float
@@ -722,16 +901,7 @@ Update(float dt)
 
     while (acc >= SIM_PERIOD)
     {
-        for (auto& components : game_struct.entities)
-        {
-            System_UpdateMovement(game_struct.ecs,
-                                  &components,
-                                  SIM_PERIOD);
-        }
-
-        System_UpdateStates();
-        System_UpdateInputQueues();
-
+        Sim_Step(game_struct);
         acc -= SIM_PERIOD;
     }
 
@@ -772,91 +942,54 @@ Render(float dt, float remainder_t)
     TIME_BLOCK;
 
     // TODO(DW): This render system is very specific to the player.
-    EntityComponentSystem& ecs            = game_struct.ecs;
-    Components*            components     = game_struct.player.components;
-    StateComponent*        state          = nullptr;
-    PositionComponent*     position       = nullptr;
-    ProjectionComponent*   projection     = nullptr;
-    BoundingBoxComponent*  bounding_box   = nullptr;
-    TextureComponent*      active_texture = nullptr;
-
-    System_UpdateMovement(ecs,
-                          components,
-                          remainder_t,
-                          /*update_projections*/ true);
+    EcsWorld&             world          = game_struct.world;
+    TextureTable&         textures       = game_struct.textures;
+    EntityId              entity         = game_struct.player.entity;
+    Int active_texture = -1;
 
-    SDL_WindowClear(game_struct.window, 100, 100, 100, 255);
-
-    if (components->state_idx >= 0)
-    {
-        state = &ecs.states[components->state_idx];
-    }
-    assert(components->position_idx >= 0);
-    {
-        position = &ecs.positions[components->position_idx];
-    }
-    if (components->projection_idx >= 0)
-    {
-        projection = &ecs.projections[components->projection_idx];
-    }
-    if (components->bounding_box_idx >= 0)
-    {
-        bounding_box = &ecs.bounding_boxes[components->bounding_box_idx];
-    }
+    // NOTE: Read through const so drawing doesn't mark anything as changed.
+    auto const* previous     = Ecs_Get<PreviousPositionComponent const>(world, entity);
+    auto const* bounding_box = Ecs_Get<BoundingBoxComponent const>(world, entity);
+    auto const* texture_set  = Ecs_Get<TextureSetComponent const>(world, entity);
 
+    SDL_WindowClear(game_struct.window, 100, 100, 100, 255);
 
-    if (state && state->movement)
-    {
-        active_texture = &ecs.textures[components->texture_idx[1]];
-    }
-    else
-    {
-        active_texture = &ecs.textures[components->texture_idx[0]];
-    }
+    // Must have a position.
+    assert(Ecs_Has<PositionComponent>(world, entity));
+    auto [position_x, position_y] = *Ecs_Get<PositionComponent const>(world, entity);
 
-    if (state && (state->action != PlayerAction::None))
-    {
-        Int index      = BitToIndex(state->action);
-        Int texture_id = state->action_texture_map[index];
-        active_texture = &ecs.textures[texture_id];
-    }
 
-    for (auto tindx : components->texture_idx)
-    {
-        ecs.textures[tindx].animate = false;
-    }
-    if (active_texture)
+    System_SelectTextures(world, textures);
+    if (texture_set)
     {
-        active_texture->animate = true;
+        active_texture = texture_set->active;
     }
 
-    float alpha = remainder_t / RENDER_PERIOD;
-    float x0    = position->x;
-    float y0    = position->y;
-    float x1 = 0, y1 = 0;
-
-    // SDL_Log("Alpha %f\n", alpha);
-
-    if (projection)
-    {
-        x1 = projection->x;
-        y1 = projection->y;
-    }
-    else
+    // The frame falls alpha of the way into the entity's next update, so draw
+    // it that far from its previous position to its current one.
+    uint32 level = EcsTickRate_EntityLevel(world, entity);
+    float  alpha = EcsTickRate_Alpha(game_struct.sim_tick, level, remainder_t, SIM_PERIOD);
+    float x0    = position_x;
+    float y0    = position_y;
+    if (previous)
     {
-        alpha = 1.0f;
+        x0 = previous->x;
+        y0 = previous->y;
     }
 
-    // static float dx = 0;
-
-    auto xdot = (x0 * alpha) + (x1 * (1.0f - alpha));
-    auto ydot = (y0 * alpha) + (y1 * (1.0f - alpha));
+    auto xdot = x0 + ((position_x - x0) * alpha);
+    auto ydot = y0 + ((position_y - y0) * alpha);
 
-    // SDL_Log("dx: %f\n", xdot - dx);
-    // dx = xdot;
+    // Only outline the boxes the spatial grid has on screen.
+    Window const&    window = game_struct.window;
+    SpatialBox const viewport { 0.0f, 0.0f, Cast(float, window.w), Cast(float, window.h) };
+    game_struct.visible.clear();
+    SpatialGrid_Query(game_struct.spatial_grid, viewport, game_struct.visible);
+    bool on_screen = std::find(game_struct.visible.begin(), game_struct.visible.end(), entity.index)
+                     != game_struct.visible.end();
 
     UByte r = 255, g = 255, b = 255, a = 255;
-    if (bounding_box)
+    if (bounding_box && on_screen)
     {
         r = bounding_box->r;
         g = bounding_box->g;
@@ -877,20 +1010,22 @@ Render(float dt, float remainder_t)
         SDL_RenderDrawRectF(game_struct.window.renderer.renderer, &rect);
     }
 
-    if (active_texture)
+    if (active_texture >= 0)
     {
-        auto     offset = (active_texture->stride * active_texture->frame) + active_texture->offset;
+        auto     texture = textures[active_texture];
+        auto&    sprite  = texture.get<Texture_Sprite>();
+        auto     offset  = (sprite.stride * texture.get<Texture_Frame>()) + sprite.offset;
         SDL_Rect src { int(offset.x + 0.5),
                        int(offset.y + 0.5),
-                       active_texture->sprite_w,
-                       active_texture->sprite_h };
-        SDL_Rect dst { Cast(int, position->x + 0.5),
-                       Cast(int, position->y + 0.5),
-                       active_texture->sprite_w * active_texture->scale,
-                       active_texture->sprite_h * active_texture->scale };
+                       sprite.sprite_w,
+                       sprite.sprite_h };
+        SDL_Rect dst { Cast(int, xdot + 0.5),
+                       Cast(int, ydot + 0.5),
+                       sprite.sprite_w * sprite.scale,
+                       sprite.sprite_h * sprite.scale };
 
         SDL_RenderCopy(game_struct.window.renderer.renderer,
-                       active_texture->texture,
+                       sprite.texture,
                        &src,
                        &dst);
     }
@@ -906,11 +1041,11 @@ void
 Setup_CapturePlayerInput(SDL_EventKeyFilter& filter)
 {
     filter._callback = &Player_OnUpdateInput;
-    filter._key_filter.push_back(SDL_SCANCODE_A);
-    filter._key_filter.push_back(SDL_SCANCODE_S);
-    filter._key_filter.push_back(SDL_SCANCODE_D);
-    filter._key_filter.push_back(SDL_SCANCODE_W);
-    filter._key_filter.push_back(SDL_SCANCODE_K);
+    filter._key_filter.set(SDL_SCANCODE_A);
+    filter._key_filter.set(SDL_SCANCODE_S);
+    filter._key_filter.set(SDL_SCANCODE_D);
+    filter._key_filter.set(SDL_SCANCODE_W);
+    filter._key_filter.set(SDL_SCANCODE_K);
 }
 
 
@@ -928,7 +1063,7 @@ Setup_CaptureEscapeKey(SDL_EventKeyFilter& filter, bool* running)
 {
     filter._callback = &App_OnKeyEscape;
     filter._userdata = Cast(void*, running);
-    filter._key_filter.push_back(SDL_SCANCODE_ESCAPE);
+    filter._key_filter.set(SDL_SCANCODE_ESCAPE);
 }
 
 
@@ -995,7 +1130,8 @@ App_MainLoop()
     // the order to be update states, render those states, and then progress the states.
     // If you animate between the Update and Render, then the state changes, and then
     // the state is immediately progressed, causes the animation to glitch slightly.
-    System_AnimateTextures(game_struct.ecs, dt);
+    EcsScheduler_Run(game_struct.frame_systems, game_struct.world, dt, &game_struct.workers);
+    Ecs_ApplyCommands(game_struct.world, game_struct.commands);
 
     prev = now;
 
@@ -1045,11 +1181,18 @@ main()
     SDL_EventQueueInit(event_q, 32);
     Setup_CaptureEscapeKey(filter, &running);
     Setup_CapturePlayerInput(game_struct.player_input_filter);
-    Player_Init(game_struct.player, game_struct.ecs);
+    Player_Init(game_struct.player, game_struct.world, game_struct.textures);
+    Setup_Systems(game_struct);
+    EcsSnapshotRing_Init(game_struct.snapshots, ROLLBACK_TICKS);
 
 #ifdef __EMSCRIPTEN__
+    // NOTE: Built without pthreads, so the systems run on the main thread.
+    WorkerPool_Init(game_struct.workers, 0);
+    EcsCommands_Init(game_struct.commands, WorkerPool_ThreadCount(game_struct.workers));
     emscripten_set_main_loop(main_loop, 0, -1);
 #else
+    WorkerPool_Init(game_struct.workers, WorkerPool_DefaultWorkerCount());
+    EcsCommands_Init(game_struct.commands, WorkerPool_ThreadCount(game_struct.workers));
     while (running)
     {
         App_MainLoop();
@@ -0,0 +1,110 @@
+#pragma once
+
+#include "Base/dllexports.h"
+#include "Base/platform/platform.h"
+#include "Base/typedefs.h"
+#include <cassert>
+#include <cstddef>
+#include <new>
+
+
+/// Arena - a linear allocator over a single virtual memory block.
+///
+/// Allocations are a pointer bump and are never freed individually, the whole
+/// arena is released at once with Arena_Reset or Arena_Free.
+struct Arena
+{
+    UByte* base;
+    uint64 size;
+    uint64 used;
+};
+
+
+inline Arena
+Arena_Make(uint64 size)
+{
+    Arena arena;
+    arena.base = Cast(UByte*, Platform_AllocateVirtualMemory(size));
+    arena.size = size;
+    arena.used = 0;
+    return arena;
+}
+
+
+inline void
+Arena_Free(Arena& arena)
+{
+    Platform_FreeVirtualMemory(arena.base, arena.size);
+    arena.base = nullptr;
+    arena.size = 0;
+    arena.used = 0;
+}
+
+
+/// Arena_Push - returns size bytes aligned to align, or nullptr if the arena is exhausted.
+inline void*
+Arena_Push(Arena& arena, uint64 size, uint64 align = alignof(std::max_align_t))
+{
+    assert((align & (align - 1)) == 0);
+
+    uint64 start = (arena.used + (align - 1)) & ~(align - 1);
+    if (start + size > arena.size)
+    {
+        return nullptr;
+    }
+
+    arena.used = start + size;
+    return arena.base + start;
+}
+
+
+inline void
+Arena_Reset(Arena& arena)
+{
+    arena.used = 0;
+}
+
+
+/// ArenaAllocator - adapts an Arena to the standard allocator interface.
+/// deallocate does nothing, memory is returned when the arena is reset.
+template <typename Tp>
+struct ArenaAllocator
+{
+    typedef Tp value_type;
+
+    Arena* arena;
+
+    ArenaAllocator(Arena* arena) noexcept
+        : arena(arena)
+    {
+    }
+
+    template <typename Up>
+    ArenaAllocator(ArenaAllocator<Up> const& other) noexcept
+        : arena(other.arena)
+    {
+    }
+
+    Tp*
+    allocate(size_t n)
+    {
+        auto* memory = Arena_Push(*arena, sizeof(Tp) * n, alignof(Tp));
+        if (!memory)
+        {
+            throw std::bad_alloc();
+        }
+        return Cast(Tp*, memory);
+    }
+
+    void
+    deallocate(Tp*, size_t) noexcept
+    {
+    }
+
+    template <typename Up>
+    bool
+    operator==(ArenaAllocator<Up> const& other) const noexcept
+    {
+        return arena == other.arena;
+    }
+};
@@ -1,15 +1,44 @@
 #pragma once
 
+#include "Base/containers/bitset.h"
 #include "Base/dllexports.h"
 #include <algorithm>
 #include <array>
+#include <cassert>
 #include <cstddef>
+#include <memory>
+#include <span>
 #include <stdexcept>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
-#define CONTAINER (*container)
+#define CONTAINER (container)
 
-template <typename _Tp, std::size_t _Nm>
+/// backfill_move - records that the element at from was moved into to by a removal.
+///
+/// Each position appears at most once per removal and the entries are in the
+/// order the moves were made, so a table indexed in parallel with the
+/// backfill_vector can be patched by replaying them in one pass.
+struct backfill_move
+{
+    std::size_t from;
+    std::size_t to;
+};
+
+/// backfill_inline - pass as the allocator of a backfill_vector to store its
+/// elements inside the object instead of allocating them.
+struct backfill_inline
+{
+};
+
+/// backfill_vector - a fixed capacity vector that fills removed slots from the back.
+///
+/// Storage for all _Nm elements is taken from _Alloc when the vector is
+/// constructed, so passing an ArenaAllocator places many vectors back to back
+/// in one arena. With backfill_inline the elements live inside the vector.
+/// A moved from vector is empty, and has no storage unless it is inline.
+template <typename _Tp, std::size_t _Nm, typename _Alloc = std::allocator<_Tp>>
 struct backfill_vector
 {
     typedef _Tp                                   value_type;
@@ -23,21 +52,93 @@ struct backfill_vector
     typedef std::ptrdiff_t                        difference_type;
     typedef std::reverse_iterator<iterator>       reverse_iterator;
     typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+    typedef _Alloc                                allocator_type;
+
+    static constexpr bool is_inline = std::is_same_v<_Alloc, backfill_inline>;
 
 private:
-    std::array<_Tp, _Nm>* container;
-    std::size_t           last { 0 };
+    struct no_storage
+    {
+    };
+
+    using AllocTraits = std::allocator_traits<std::conditional_t<is_inline, std::allocator<_Tp>, _Alloc>>;
+    using InlineItems = std::conditional_t<is_inline, std::array<_Tp, _Nm>, no_storage>;
+
+    _Tp*        container { nullptr };
+    std::size_t last { 0 };
+
+    [[no_unique_address]] _Alloc      alloc;
+    [[no_unique_address]] InlineItems items;
 
 public:
     // Constructors.
-    backfill_vector()
+    explicit backfill_vector(_Alloc const& alloc = _Alloc())
+        : alloc(alloc)
+    {
+        acquire();
+    }
+
+    backfill_vector(backfill_vector const& other)
+        : alloc(select_on_copy(other.alloc))
     {
-        container = new std::array<_Tp, _Nm>;
+        acquire();
+        std::copy(other.begin(), other.end(), begin());
+        last = other.last;
+    }
+
+    backfill_vector(backfill_vector&& other) noexcept
+        : alloc(other.alloc)
+    {
+        if constexpr (is_inline)
+        {
+            acquire();
+            std::move(other.begin(), other.end(), begin());
+        }
+        else
+        {
+            container = std::exchange(other.container, nullptr);
+        }
+        last = std::exchange(other.last, 0);
+    }
+
+    backfill_vector&
+    operator=(backfill_vector const& other)
+    {
+        if (this != &other)
+        {
+            if (!container)
+            {
+                acquire();
+            }
+            std::copy(other.begin(), other.end(), begin());
+            last = other.last;
+        }
+        return *this;
+    }
+
+    backfill_vector&
+    operator=(backfill_vector&& other) noexcept
+    {
+        if (this != &other)
+        {
+            if constexpr (is_inline)
+            {
+                std::move(other.begin(), other.end(), begin());
+            }
+            else
+            {
+                release();
+                alloc     = other.alloc;
+                container = std::exchange(other.container, nullptr);
+            }
+            last = std::exchange(other.last, 0);
+        }
+        return *this;
     }
 
     ~backfill_vector()
     {
-        delete container;
+        release();
     }
 
     // Iterators.
@@ -45,19 +146,19 @@ public:
     constexpr auto
     begin() noexcept
     {
-        return CONTAINER.begin();
+        return iterator(container);
     }
 
     constexpr auto
     begin() const noexcept
     {
-        return CONTAINER.cbegin();
+        return const_iterator(container);
     }
 
     constexpr auto
     cbegin() const noexcept
     {
-        return CONTAINER.cbegin();
+        return const_iterator(container);
     }
 
 
@@ -65,19 +166,19 @@ public:
     constexpr auto
     rend() noexcept
     {
-        return CONTAINER.rend();
+        return reverse_iterator(begin());
     }
 
     constexpr auto
     rend() const noexcept
     {
-        return CONTAINER.crend();
+        return const_reverse_iterator(begin());
     }
 
     constexpr auto
     crend() const noexcept
     {
-        return CONTAINER.crend();
+        return const_reverse_iterator(cbegin());
     }
 
 
@@ -85,19 +186,19 @@ public:
     constexpr auto
     end() noexcept
     {
-        return CONTAINER.begin() + last;
+        return iterator(container + last);
     }
 
     constexpr auto
     end() const noexcept
     {
-        return CONTAINER.cbegin() + last;
+        return const_iterator(container + last);
     }
 
     constexpr auto
     cend() const noexcept
     {
-        return CONTAINER.cbegin() + last;
+        return const_iterator(container + last);
     }
 
 
@@ -105,19 +206,19 @@ public:
     constexpr auto
     rbegin() noexcept
     {
-        return CONTAINER.rbegin() + (_Nm - last);
+        return reverse_iterator(end());
     }
 
     constexpr auto
     rbegin() const noexcept
     {
-        return CONTAINER.rbegin() + (_Nm - last);
+        return const_reverse_iterator(end());
     }
 
     constexpr auto
     crbegin() const noexcept
     {
-        return CONTAINER.crbegin() + (_Nm - last);
+        return const_reverse_iterator(cend());
     }
 
 
@@ -148,10 +249,11 @@ public:
         return last;
     }
 
+    /// capacity - _Nm, or 0 for a moved from vector that no longer owns storage.
     constexpr size_type
     capacity() const noexcept
     {
-        return _Nm;
+        return container ? _Nm : 0;
     }
 
     [[nodiscard]] constexpr bool
@@ -165,11 +267,11 @@ public:
     reference
     at(std::size_t pos)
     {
-        if (pos < 0 || pos >= last)
+        if (pos >= last)
         {
             throw std::out_of_range("invalid access of backfill_vector.");
         }
-        return CONTAINER.at(pos);
+        return CONTAINER[pos];
     }
 
     reference
@@ -178,6 +280,24 @@ public:
         return CONTAINER[pos];
     }
 
+    const_reference
+    operator[](size_t pos) const
+    {
+        return CONTAINER[pos];
+    }
+
+    pointer
+    data() noexcept
+    {
+        return container;
+    }
+
+    const_pointer
+    data() const noexcept
+    {
+        return container;
+    }
+
     // Modifiers.
     /// @brief increases the container size up to a maximum of capacity.
     /// The new item can be accessed using back().
@@ -192,72 +312,140 @@ public:
         last = next;
     }
 
-    void
-    remove(size_type pos) noexcept(false)
+    /// @brief removes the element at pos by moving the back element into it.
+    /// If journal is not empty the relocation is recorded in it.
+    /// Returns the number of relocations, 0 or 1.
+    size_type
+    remove(size_type pos, std::span<backfill_move> journal = {}) noexcept(false)
     {
-        using std::swap;
-        auto& back = CONTAINER.at(last - 1);
-        auto& x    = CONTAINER.at(pos);
+        if (pos >= last)
+        {
+            throw std::out_of_range("invalid removal from backfill_vector.");
+        }
 
-        x = std::move(back);
+        auto&     back  = CONTAINER[last - 1];
+        auto&     x     = CONTAINER[pos];
+        size_type moved = 0;
+
+        if (&x != &back)
+        {
+            x = std::move(back);
+            record(journal, moved, last - 1, pos);
+        }
         last -= 1;
+        return moved;
     }
 
-    void
-    remove(std::vector<std::size_t> idx)
+    /// @brief removes every valid index in idx, duplicates and out of range
+    /// indices are ignored. Runs in O(k log k) for k indices and does not
+    /// allocate, but sorts idx in place.
+    ///
+    /// Indices are removed in ascending order, each hole is filled from the
+    /// back unless that back element is itself being removed.
+    ///
+    /// If journal is not empty every relocation is recorded in it, so it needs
+    /// room for idx.size() entries, otherwise nothing is removed and it throws
+    /// std::out_of_range. Returns the number of relocations.
+    size_type
+    remove(std::span<std::size_t> idx, std::span<backfill_move> journal = {}) noexcept(false)
     {
-        // a is the current value to look at.
-        // pivot is the position after partitioning using the value of a.
-        auto                  pivot = idx.begin();
-        decltype(idx.begin()) a;
-        std::size_t           back = size() - 1;
+        if (!journal.empty() && journal.size() < idx.size())
+        {
+            throw std::out_of_range("journal too small for backfill_vector removal.");
+        }
+
+        std::sort(idx.begin(), idx.end());
+        auto end = std::unique(idx.begin(), idx.end());
+        end      = std::lower_bound(idx.begin(), end, last);
 
-        while (pivot < idx.end())
+        size_type moved = 0;
+        if (idx.begin() == end)
         {
-            // 2 4 6 2 becomes
-            // 2 2 4 6
-            //
-            // a p   e
+            return moved;
+        }
 
-            a     = pivot;
-            pivot = std::partition(a, idx.end(), [a](auto const& item) { return item == *a; });
+        // lo walks up through the holes, hi walks down through the indices
+        // that are at the back and so can be dropped without a move.
+        auto        lo   = idx.begin();
+        auto        hi   = end - 1;
+        std::size_t back = last - 1;
 
-            if (*a >= size())
+        while (true)
+        {
+            while (*hi == back)
             {
-                pivot += 1;
-                continue;
+                back -= 1;
+                if (hi == lo)
+                {
+                    last = back + 1;
+                    return moved;
+                }
+                hi -= 1;
             }
 
-            while (true)
+            CONTAINER[*lo] = std::move(CONTAINER[back]);
+            record(journal, moved, back, *lo);
+            back -= 1;
+
+            if (lo == hi)
             {
-                // Then check if the back is also to be removed - i.e. it is
-                // not a valid swap location.
-                auto count = std::count(pivot, idx.end(), back);
+                break;
+            }
+            lo += 1;
+        }
 
-                if (count == 0)
-                {
-                    break;
-                }
+        last = back + 1;
+        return moved;
+    }
 
-                back -= 1; // try a different back location.
-            }
+    size_type
+    remove(std::vector<std::size_t> idx, std::span<backfill_move> journal = {}) noexcept(false)
+    {
+        return remove(std::span<std::size_t>(idx), journal);
+    }
 
-            if (back < *a)
+    /// @brief removes every element whose bit is set in mask, in O(n/64).
+    /// Gives the same result as removing the set indices with remove(span).
+    ///
+    /// If journal is not empty it needs room for mask.count() entries,
+    /// otherwise nothing is removed and it throws std::out_of_range.
+    size_type
+    remove(BitSet<_Nm> const& mask, std::span<backfill_move> journal = {}) noexcept(false)
+    {
+        if (!journal.empty() && journal.size() < mask.count())
+        {
+            throw std::out_of_range("journal too small for backfill_vector removal.");
+        }
+
+        size_type moved = 0;
+        if (last == 0)
+        {
+            return moved;
+        }
+
+        std::size_t back = last - 1;
+        std::size_t pos  = mask.find_first();
+
+        while (pos <= back)
+        {
+            while (mask.test(back))
             {
-                // The item at a has been removed by reducing the back.
-                // No swap is required.
-                continue;
+                if (back == pos)
+                {
+                    last = back;
+                    return moved;
+                }
+                back -= 1;
             }
 
-            using std::swap;
-            auto& item      = at(back);
-            auto& to_remove = at(*a);
-            swap(to_remove, item);
-
+            CONTAINER[pos] = std::move(CONTAINER[back]);
+            record(journal, moved, back, pos);
             back -= 1;
+            pos = mask.find_next(pos + 1);
         }
 
         last = back + 1;
+        return moved;
     }
 
     void
@@ -265,6 +453,65 @@ public:
     {
         last = 0;
     }
+
+private:
+    static _Alloc
+    select_on_copy(_Alloc const& other)
+    {
+        if constexpr (is_inline)
+        {
+            return other;
+        }
+        else
+        {
+            return AllocTraits::select_on_container_copy_construction(other);
+        }
+    }
+
+    /// acquire - points container at storage for _Nm default initialised elements.
+    void
+    acquire()
+    {
+        if constexpr (is_inline)
+        {
+            container = items.data();
+        }
+        else
+        {
+            container = AllocTraits::allocate(alloc, _Nm);
+            std::uninitialized_default_construct_n(container, _Nm);
+        }
+    }
+
+    void
+    release() noexcept
+    {
+        if constexpr (!is_inline)
+        {
+            if (container)
+            {
+                std::destroy_n(container, _Nm);
+                AllocTraits::deallocate(alloc, container, _Nm);
+                container = nullptr;
+            }
+        }
+        last = 0;
+    }
+
+    static void
+    record(std::span<backfill_move> journal, size_type& moved, std::size_t from, std::size_t to)
+    {
+        // NOTE: The removals check the journal is big enough before moving anything.
+        if (!journal.empty())
+        {
+            assert(moved < journal.size());
+            journal[moved] = { from, to };
+        }
+        moved += 1;
+    }
 };
 
+template <typename _Tp, std::size_t _Nm>
+using inline_backfill_vector = backfill_vector<_Tp, _Nm, backfill_inline>;
+
 #undef CONTAINER
\ No newline at end of file
@@ -0,0 +1,352 @@
+#pragma once
+
+#include "Base/dllexports.h"
+#include "Base/typedefs.h"
+#include <bit>
+#include <cassert>
+#include <cstddef>
+
+#if defined(__AVX2__) || defined(__SSE2__) || defined(_M_X64)
+#include <immintrin.h>
+#endif
+
+
+/// Bits_IndexOfFirstSet - index of the lowest set bit, or -1 if no bits are set.
+inline Int
+Bits_IndexOfFirstSet(uint64 value)
+{
+    return value ? std::countr_zero(value) : -1;
+}
+
+
+template <size_t Nm>
+struct BitSet
+{
+    static constexpr size_t WORD_BITS = 64;
+    static constexpr size_t NUM_WORDS = (Nm + WORD_BITS - 1) / WORD_BITS;
+
+    // Data members
+    //
+    // NOTE: Aligned so the set operations can use aligned 256 bit loads.
+    alignas(32) uint64 words[NUM_WORDS] {};
+
+    // Iterators.
+    /// iterator - a forward iterator over the indices of the set bits.
+    struct iterator
+    {
+        uint64 const* words;
+        size_t        word_idx;
+        uint64        current;
+
+        size_t
+        operator*() const noexcept
+        {
+            return (word_idx * WORD_BITS) + std::countr_zero(current);
+        }
+
+        iterator&
+        operator++() noexcept
+        {
+            // Clear the lowest set bit, then skip forward over empty words.
+            current &= current - 1;
+            while (current == 0 && ++word_idx < NUM_WORDS)
+            {
+                current = words[word_idx];
+            }
+            return *this;
+        }
+
+        bool
+        operator==(iterator const& other) const noexcept
+        {
+            return word_idx == other.word_idx && current == other.current;
+        }
+    };
+
+    iterator
+    begin() const noexcept
+    {
+        iterator it { words, 0, words[0] };
+        while (it.current == 0 && ++it.word_idx < NUM_WORDS)
+        {
+            it.current = words[it.word_idx];
+        }
+        return it;
+    }
+
+    iterator
+    end() const noexcept
+    {
+        return iterator { words, NUM_WORDS, 0 };
+    }
+
+
+    // Modifiers.
+    //
+    void
+    set(size_t pos) noexcept
+    {
+        assert(pos < Nm);
+        words[pos / WORD_BITS] |= (uint64(1) << (pos % WORD_BITS));
+    }
+
+    void
+    reset(size_t pos) noexcept
+    {
+        assert(pos < Nm);
+        words[pos / WORD_BITS] &= ~(uint64(1) << (pos % WORD_BITS));
+    }
+
+    void
+    clear() noexcept
+    {
+        for (auto& word : words)
+        {
+            word = 0;
+        }
+    }
+
+
+    // Access Functions.
+    //
+    constexpr bool
+    test(size_t pos) const noexcept
+    {
+        assert(pos < Nm);
+        return (words[pos / WORD_BITS] >> (pos % WORD_BITS)) & 1;
+    }
+
+    constexpr bool
+    operator[](size_t pos) const noexcept
+    {
+        return test(pos);
+    }
+
+
+    // Capacity Functions.
+    //
+    constexpr size_t
+    size() const noexcept
+    {
+        return Nm;
+    }
+
+    /// count - the number of set bits.
+    size_t
+    count() const noexcept
+    {
+        size_t total = 0;
+        for (auto word : words)
+        {
+            total += std::popcount(word);
+        }
+        return total;
+    }
+
+    bool
+    any() const noexcept
+    {
+        for (auto word : words)
+        {
+            if (word)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool
+    none() const noexcept
+    {
+        return !any();
+    }
+
+
+    // Search Functions.
+    //
+    /// find_first - index of the first set bit, or size() if no bits are set.
+    size_t
+    find_first() const noexcept
+    {
+        return find_next(0);
+    }
+
+    /// find_next - index of the first set bit at or after pos, or size() if there is none.
+    size_t
+    find_next(size_t pos) const noexcept
+    {
+        if (pos >= Nm)
+        {
+            return Nm;
+        }
+
+        size_t word_idx = pos / WORD_BITS;
+        uint64 word     = words[word_idx] & (~uint64(0) << (pos % WORD_BITS));
+
+        while (true)
+        {
+            if (word)
+            {
+                return (word_idx * WORD_BITS) + std::countr_zero(word);
+            }
+            if (++word_idx == NUM_WORDS)
+            {
+                return Nm;
+            }
+            word = words[word_idx];
+        }
+    }
+
+
+    // Set Operations.
+    //
+    BitSet&
+    operator&=(BitSet const& other) noexcept
+    {
+        BitSet_And(*this, other);
+        return *this;
+    }
+
+    BitSet&
+    operator|=(BitSet const& other) noexcept
+    {
+        BitSet_Or(*this, other);
+        return *this;
+    }
+
+    /// and_not - clears every bit that is set in other.
+    BitSet&
+    and_not(BitSet const& other) noexcept
+    {
+        BitSet_AndNot(*this, other);
+        return *this;
+    }
+
+    /// contains - true if every bit set in other is also set in this.
+    bool
+    contains(BitSet const& other) const noexcept
+    {
+        for (size_t i = 0; i < NUM_WORDS; ++i)
+        {
+            if ((words[i] & other.words[i]) != other.words[i])
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /// intersects - true if at least one bit is set in both.
+    bool
+    intersects(BitSet const& other) const noexcept
+    {
+        for (size_t i = 0; i < NUM_WORDS; ++i)
+        {
+            if (words[i] & other.words[i])
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool
+    operator==(BitSet const& other) const noexcept
+    {
+        for (size_t i = 0; i < NUM_WORDS; ++i)
+        {
+            if (words[i] != other.words[i])
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+
+//////////////////////////////////////////////////////////////////////////////
+
+// NOTE: The set operations process whole registers and fall through to the
+// next narrower width for the remaining words, so any Nm is supported.
+
+#define BITSET_BINARY_OP(name, avx2_op, sse2_op, scalar_expr)                    \
+    template <size_t Nm>                                                         \
+    void name(BitSet<Nm>& a, BitSet<Nm> const& b) noexcept                       \
+    {                                                                            \
+        constexpr size_t N = BitSet<Nm>::NUM_WORDS;                              \
+        size_t           i = 0;                                                  \
+        BITSET_AVX2_LOOP(avx2_op)                                                \
+        BITSET_SSE2_LOOP(sse2_op)                                                \
+        for (; i < N; ++i)                                                       \
+        {                                                                        \
+            uint64 x = a.words[i];                                               \
+            uint64 y = b.words[i];                                               \
+            a.words[i] = (scalar_expr);                                          \
+        }                                                                        \
+    }
+
+#if defined(__AVX2__)
+#define BITSET_AVX2_LOOP(op)                                                     \
+    for (; i + 4 <= N; i += 4)                                                   \
+    {                                                                            \
+        auto x = _mm256_load_si256((__m256i const*)&a.words[i]);                 \
+        auto y = _mm256_load_si256((__m256i const*)&b.words[i]);                 \
+        _mm256_store_si256((__m256i*)&a.words[i], op(x, y));                     \
+    }
+#else
+#define BITSET_AVX2_LOOP(op)
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64)
+#define BITSET_SSE2_LOOP(op)                                                     \
+    for (; i + 2 <= N; i += 2)                                                   \
+    {                                                                            \
+        auto x = _mm_load_si128((__m128i const*)&a.words[i]);                    \
+        auto y = _mm_load_si128((__m128i const*)&b.words[i]);                    \
+        _mm_store_si128((__m128i*)&a.words[i], op(x, y));                        \
+    }
+#else
+#define BITSET_SSE2_LOOP(op)
+#endif
+
+// NOTE: andnot intrinsics compute (~first & second), hence the swapped arguments.
+#define BITSET_AVX2_ANDNOT(x, y) _mm256_andnot_si256((y), (x))
+#define BITSET_SSE2_ANDNOT(x, y) _mm_andnot_si128((y), (x))
+
+BITSET_BINARY_OP(BitSet_And, _mm256_and_si256, _mm_and_si128, x & y)
+BITSET_BINARY_OP(BitSet_Or, _mm256_or_si256, _mm_or_si128, x | y)
+BITSET_BINARY_OP(BitSet_AndNot, BITSET_AVX2_ANDNOT, BITSET_SSE2_ANDNOT, x & ~y)
+
+#undef BITSET_BINARY_OP
+#undef BITSET_AVX2_LOOP
+#undef BITSET_SSE2_LOOP
+#undef BITSET_AVX2_ANDNOT
+#undef BITSET_SSE2_ANDNOT
+
+
+template <size_t Nm>
+BitSet<Nm>
+operator&(BitSet<Nm> const& a, BitSet<Nm> const& b) noexcept
+{
+    BitSet<Nm> result = a;
+    BitSet_And(result, b);
+    return result;
+}
+
+template <size_t Nm>
+BitSet<Nm>
+operator|(BitSet<Nm> const& a, BitSet<Nm> const& b) noexcept
+{
+    BitSet<Nm> result = a;
+    BitSet_Or(result, b);
+    return result;
+}
+
+template <size_t Nm>
+size_t
+BitSet_Count(BitSet<Nm> const& bits) noexcept
+{
+    return bits.count();
+}
@@ -0,0 +1,387 @@
+#pragma once
+
+#include "Base/dllexports.h"
+#include "Base/typedefs.h"
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+#include <functional>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define FIXEDMAP_SSE2 1
+#endif
+
+
+/// FixedMap - an open addressing hash map with inline storage.
+///
+/// Each slot has a control byte holding either EMPTY or the low 7 bits of the
+/// key's hash (H2), the remaining bits (H1) choose the home slot. Lookups
+/// compare a whole group of control bytes against H2 at once and only touch
+/// the slots that match.
+///
+/// Collisions are resolved with linear probing so erase can shift the
+/// following entries back into the hole, meaning no tombstones are left
+/// behind and lookups never slow down as entries come and go.
+template <typename Key, typename Tp, size_t Nm, typename Hash = std::hash<Key>>
+struct FixedMap
+{
+    static_assert(Nm >= 16 && std::has_single_bit(Nm), "FixedMap capacity must be a power of two >= 16.");
+
+    static constexpr size_t GROUP_WIDTH = 16;
+    static constexpr size_t MASK        = Nm - 1;
+    static constexpr UByte  EMPTY       = 0x80;
+
+    // NOTE: At least one slot is always left empty so that probing terminates.
+    static constexpr size_t MAX_SIZE = Nm - (Nm / 8);
+
+    struct Slot
+    {
+        Key first;
+        Tp  second;
+    };
+
+    typedef Key         key_type;
+    typedef Tp          mapped_type;
+    typedef Slot        value_type;
+    typedef value_type& reference;
+
+    // Data members
+    //
+    // NOTE: The first GROUP_WIDTH control bytes are mirrored after the end so
+    // a group can always be loaded with a single unaligned read.
+    UByte  ctrl[Nm + GROUP_WIDTH];
+    Slot   slots[Nm];
+    size_t count { 0 };
+
+    FixedMap()
+    {
+        std::memset(ctrl, EMPTY, sizeof(ctrl));
+    }
+
+
+    // Iterators.
+    /// iterator - a forward iterator over the occupied slots.
+    template <typename MapTp, typename SlotTp>
+    struct basic_iterator
+    {
+        MapTp* map;
+        size_t pos;
+
+        SlotTp&
+        operator*() const noexcept
+        {
+            return map->slots[pos];
+        }
+
+        SlotTp*
+        operator->() const noexcept
+        {
+            return &map->slots[pos];
+        }
+
+        basic_iterator&
+        operator++() noexcept
+        {
+            pos = map->next_full(pos + 1);
+            return *this;
+        }
+
+        bool
+        operator==(basic_iterator const& other) const noexcept
+        {
+            return pos == other.pos;
+        }
+    };
+
+    typedef basic_iterator<FixedMap, Slot>             iterator;
+    typedef basic_iterator<FixedMap const, Slot const> const_iterator;
+
+    iterator
+    begin() noexcept
+    {
+        return iterator { this, next_full(0) };
+    }
+
+    const_iterator
+    begin() const noexcept
+    {
+        return const_iterator { this, next_full(0) };
+    }
+
+    iterator
+    end() noexcept
+    {
+        return iterator { this, Nm };
+    }
+
+    const_iterator
+    end() const noexcept
+    {
+        return const_iterator { this, Nm };
+    }
+
+
+    // Capacity Functions.
+    //
+    constexpr size_t
+    size() const noexcept
+    {
+        return count;
+    }
+
+    constexpr size_t
+    capacity() const noexcept
+    {
+        return MAX_SIZE;
+    }
+
+    constexpr bool
+    empty() const noexcept
+    {
+        return count == 0;
+    }
+
+    constexpr bool
+    full() const noexcept
+    {
+        return count == MAX_SIZE;
+    }
+
+
+    // Access Functions.
+    //
+    /// find - returns a pointer to the value for key, or nullptr if it is not in the map.
+    Tp*
+    find(Key const& key) noexcept
+    {
+        auto pos = find_slot(key);
+        return pos < Nm ? &slots[pos].second : nullptr;
+    }
+
+    Tp const*
+    find(Key const& key) const noexcept
+    {
+        auto pos = find_slot(key);
+        return pos < Nm ? &slots[pos].second : nullptr;
+    }
+
+    bool
+    contains(Key const& key) const noexcept
+    {
+        return find_slot(key) < Nm;
+    }
+
+    /// operator[] - returns the value for key, value initialising it if it is not in the map.
+    Tp&
+    operator[](Key const& key)
+    {
+        auto* value = insert(key);
+        assert(value && "FixedMap is full.");
+        return *value;
+    }
+
+
+    // Modifiers.
+    //
+    /// insert - returns the value for key, value initialising it if it is not
+    /// in the map. Returns nullptr if the key is new and the map is full.
+    Tp*
+    insert(Key const& key)
+    {
+        auto hash = hash_of(key);
+        auto pos  = find_slot(key, hash);
+        if (pos < Nm)
+        {
+            return &slots[pos].second;
+        }
+
+        if (full())
+        {
+            return nullptr;
+        }
+
+        pos = find_empty(H1(hash));
+        set_ctrl(pos, H2(hash));
+        slots[pos].first  = key;
+        slots[pos].second = Tp {};
+        count += 1;
+        return &slots[pos].second;
+    }
+
+    Tp*
+    insert(Key const& key, Tp const& value)
+    {
+        auto* item = insert(key);
+        if (item)
+        {
+            *item = value;
+        }
+        return item;
+    }
+
+    /// erase - removes key from the map. Returns false if it was not in the map.
+    bool
+    erase(Key const& key)
+    {
+        auto hole = find_slot(key);
+        if (hole >= Nm)
+        {
+            return false;
+        }
+
+        // Backward shift deletion. Walk the cluster after the hole and move
+        // back any entry whose home slot is at or before the hole.
+        auto next = (hole + 1) & MASK;
+        while (ctrl[next] != EMPTY)
+        {
+            auto home = H1(hash_of(slots[next].first));
+            if (((hole - home) & MASK) < ((next - home) & MASK))
+            {
+                slots[hole] = std::move(slots[next]);
+                set_ctrl(hole, ctrl[next]);
+                hole = next;
+            }
+            next = (next + 1) & MASK;
+        }
+
+        set_ctrl(hole, EMPTY);
+        slots[hole] = Slot {};
+        count -= 1;
+        return true;
+    }
+
+    void
+    clear()
+    {
+        std::memset(ctrl, EMPTY, sizeof(ctrl));
+        for (auto& slot : slots)
+        {
+            slot = Slot {};
+        }
+        count = 0;
+    }
+
+
+    // Implementation.
+    //
+    static uint64
+    hash_of(Key const& key) noexcept
+    {
+        // NOTE: std::hash is the identity for integers and pointers, so mix the
+        // bits to spread them over both H1 and H2.
+        uint64 h = Hash {}(key);
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdull;
+        h ^= h >> 33;
+        return h;
+    }
+
+    static constexpr size_t
+    H1(uint64 hash) noexcept
+    {
+        return (hash >> 7) & MASK;
+    }
+
+    static constexpr UByte
+    H2(uint64 hash) noexcept
+    {
+        return hash & 0x7f;
+    }
+
+    void
+    set_ctrl(size_t pos, UByte value) noexcept
+    {
+        ctrl[pos] = value;
+        if (pos < GROUP_WIDTH)
+        {
+            ctrl[Nm + pos] = value;
+        }
+    }
+
+    /// match - bit i is set if control byte pos + i equals value.
+    uint32
+    match(size_t pos, UByte value) const noexcept
+    {
+#if defined(FIXEDMAP_SSE2)
+        auto group = _mm_loadu_si128((__m128i const*)&ctrl[pos]);
+        return _mm_movemask_epi8(_mm_cmpeq_epi8(group, _mm_set1_epi8(value)));
+#else
+        uint32 mask = 0;
+        for (size_t i = 0; i < GROUP_WIDTH; ++i)
+        {
+            mask |= uint32(ctrl[pos + i] == value) << i;
+        }
+        return mask;
+#endif
+    }
+
+    size_t
+    find_slot(Key const& key) const noexcept
+    {
+        return find_slot(key, hash_of(key));
+    }
+
+    size_t
+    find_slot(Key const& key, uint64 hash) const noexcept
+    {
+        auto pos = H1(hash);
+        auto h2  = H2(hash);
+
+        while (true)
+        {
+            for (auto bits = match(pos, h2); bits; bits &= bits - 1)
+            {
+                auto index = (pos + std::countr_zero(bits)) & MASK;
+                if (slots[index].first == key)
+                {
+                    return index;
+                }
+            }
+
+            // With linear probing a key can never be stored past the first
+            // empty slot after its home.
+            if (match(pos, EMPTY))
+            {
+                return Nm;
+            }
+
+            pos = (pos + GROUP_WIDTH) & MASK;
+        }
+    }
+
+    size_t
+    find_empty(size_t pos) const noexcept
+    {
+        while (true)
+        {
+            auto bits = match(pos, EMPTY);
+            if (bits)
+            {
+                return (pos + std::countr_zero(bits)) & MASK;
+            }
+            pos = (pos + GROUP_WIDTH) & MASK;
+        }
+    }
+
+    size_t
+    next_full(size_t pos) const noexcept
+    {
+        while (pos < Nm && ctrl[pos] == EMPTY)
+        {
+            pos += 1;
+        }
+        return pos;
+    }
+};
+
+#undef FIXEDMAP_SSE2
+
+
+template <typename Key, typename Tp, size_t Nm, typename Hash>
+constexpr size_t
+FixedMap_Size(FixedMap<Key, Tp, Nm, Hash> const& map) noexcept
+{
+    return map.count;
+}
@@ -0,0 +1,221 @@
+#pragma once
+
+#include "Base/dllexports.h"
+#include "Base/typedefs.h"
+#include <cassert>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+
+/// SlotHandle - refers to an element of a SlotMap.
+///
+/// The generation is bumped every time a slot is erased, so a handle to an
+/// erased element never resolves, even after the slot has been reused.
+struct SlotHandle
+{
+    uint32 index;
+    uint32 generation;
+
+    bool
+    operator==(SlotHandle const& other) const noexcept
+    {
+        return index == other.index && generation == other.generation;
+    }
+};
+
+constexpr SlotHandle const SLOT_HANDLE_INVALID { UINT32_MAX, UINT32_MAX };
+
+
+/// SlotMap - dense storage addressed through stable, generational handles.
+///
+/// Elements are kept packed in a vector so iteration is a linear scan. Each
+/// handle goes through a sparse slot that records where its element currently
+/// lives, and erase moves the back element into the hole and patches its slot.
+/// Free slots are kept in an intrusive free list, so insert, erase and lookup
+/// are all O(1).
+template <typename _Tp>
+struct SlotMap
+{
+    typedef _Tp               value_type;
+    typedef value_type&       reference;
+    typedef const value_type& const_reference;
+    typedef value_type*       iterator;
+    typedef const value_type* const_iterator;
+
+    static constexpr uint32 FREE_LIST_END = UINT32_MAX;
+
+    struct Slot
+    {
+        // Position of the element in dense when in use, otherwise the next free slot.
+        uint32 dense_or_next_free;
+        uint32 generation;
+    };
+
+    // Data members
+    //
+    std::vector<_Tp>    dense;
+    std::vector<uint32> dense_to_slot;
+    std::vector<Slot>   slots;
+    uint32              free_head { FREE_LIST_END };
+
+    // Modifiers.
+    //
+    SlotHandle
+    insert(_Tp value)
+    {
+        uint32 slot_idx;
+        if (free_head != FREE_LIST_END)
+        {
+            slot_idx  = free_head;
+            free_head = slots[slot_idx].dense_or_next_free;
+        }
+        else
+        {
+            slot_idx = Cast(uint32, slots.size());
+            slots.push_back({ 0, 0 });
+        }
+
+        auto& slot              = slots[slot_idx];
+        slot.dense_or_next_free = Cast(uint32, dense.size());
+
+        dense.push_back(std::move(value));
+        dense_to_slot.push_back(slot_idx);
+
+        return { slot_idx, slot.generation };
+    }
+
+    /// erase - removes the element for handle. Returns false if the handle is stale.
+    bool
+    erase(SlotHandle handle)
+    {
+        if (!contains(handle))
+        {
+            return false;
+        }
+
+        auto&  slot = slots[handle.index];
+        uint32 hole = slot.dense_or_next_free;
+        uint32 back = Cast(uint32, dense.size() - 1);
+
+        if (hole != back)
+        {
+            dense[hole]         = std::move(dense[back]);
+            dense_to_slot[hole] = dense_to_slot[back];
+
+            slots[dense_to_slot[hole]].dense_or_next_free = hole;
+        }
+        dense.pop_back();
+        dense_to_slot.pop_back();
+
+        slot.generation += 1;
+
+        slot.dense_or_next_free = free_head;
+        free_head               = handle.index;
+        return true;
+    }
+
+    void
+    clear()
+    {
+        while (!dense.empty())
+        {
+            erase(handle_at(dense.size() - 1));
+        }
+    }
+
+    void
+    reserve(size_t n)
+    {
+        dense.reserve(n);
+        dense_to_slot.reserve(n);
+        slots.reserve(n);
+    }
+
+
+    // Access Functions.
+    //
+    bool
+    contains(SlotHandle handle) const noexcept
+    {
+        return handle.index < slots.size() && slots[handle.index].generation == handle.generation;
+    }
+
+    /// get - the element for handle, or nullptr if the handle is stale.
+    _Tp*
+    get(SlotHandle handle) noexcept
+    {
+        return contains(handle) ? &dense[slots[handle.index].dense_or_next_free] : nullptr;
+    }
+
+    _Tp const*
+    get(SlotHandle handle) const noexcept
+    {
+        return contains(handle) ? &dense[slots[handle.index].dense_or_next_free] : nullptr;
+    }
+
+    /// handle_at - the handle for the element at position pos of the dense storage.
+    SlotHandle
+    handle_at(size_t pos) const noexcept
+    {
+        assert(pos < dense.size());
+        uint32 slot_idx = dense_to_slot[pos];
+        return { slot_idx, slots[slot_idx].generation };
+    }
+
+    reference
+    operator[](size_t pos)
+    {
+        assert(pos < dense.size());
+        return dense[pos];
+    }
+
+    const_reference
+    operator[](size_t pos) const
+    {
+        assert(pos < dense.size());
+        return dense[pos];
+    }
+
+
+    // Iterators.
+    /// begin - a forward iterator over the dense elements, in no particular order.
+    iterator
+    begin() noexcept
+    {
+        return dense.data();
+    }
+
+    const_iterator
+    begin() const noexcept
+    {
+        return dense.data();
+    }
+
+    iterator
+    end() noexcept
+    {
+        return dense.data() + dense.size();
+    }
+
+    const_iterator
+    end() const noexcept
+    {
+        return dense.data() + dense.size();
+    }
+
+
+    // Capacity Functions.
+    //
+    size_t
+    size() const noexcept
+    {
+        return dense.size();
+    }
+
+    bool
+    empty() const noexcept
+    {
+        return dense.empty();
+    }
+};
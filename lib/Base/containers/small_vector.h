@@ -0,0 +1,323 @@
+#pragma once
+
+#include "Base/dllexports.h"
+#include "Base/typedefs.h"
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+#define CONTAINER (container)
+
+
+/// SmallVector - stores up to Nm elements inline and moves them to storage
+/// from _Alloc once it grows past that.
+///
+/// The interface mirrors Array so code can switch between the two, but there
+/// is no fixed upper limit. Pass an ArenaAllocator to keep the spilled storage
+/// out of the general heap.
+template <typename _Tp, size_t Nm, typename _Alloc = std::allocator<_Tp>>
+struct SmallVector
+{
+    typedef _Tp               value_type;
+    typedef value_type*       pointer;
+    typedef const value_type* const_pointer;
+    typedef value_type&       reference;
+    typedef const value_type& const_reference;
+    typedef value_type*       iterator;
+    typedef const value_type* const_iterator;
+    typedef ptrdiff_t         difference_type;
+    typedef _Alloc            allocator_type;
+
+    using AllocTraits = std::allocator_traits<_Alloc>;
+
+    // Data members
+    //
+    _Tp*   container;
+    size_t last { 0 };
+    size_t cap { Nm };
+
+    [[no_unique_address]] _Alloc alloc;
+
+    alignas(_Tp) unsigned char buffer[sizeof(_Tp) * Nm];
+
+    // Constructors.
+    SmallVector(_Alloc const& alloc = _Alloc())
+        : container(inline_data())
+        , alloc(alloc)
+    {
+    }
+
+    SmallVector(SmallVector const& other)
+        : container(inline_data())
+        , alloc(AllocTraits::select_on_container_copy_construction(other.alloc))
+    {
+        grow_to(other.last);
+        std::uninitialized_copy(other.begin(), other.end(), container);
+        last = other.last;
+    }
+
+    SmallVector(SmallVector&& other) noexcept
+        : container(inline_data())
+        , alloc(other.alloc)
+    {
+        take(other);
+    }
+
+    SmallVector&
+    operator=(SmallVector const& other)
+    {
+        if (this != &other)
+        {
+            clear();
+            grow_to(other.last);
+            std::uninitialized_copy(other.begin(), other.end(), container);
+            last = other.last;
+        }
+        return *this;
+    }
+
+    SmallVector&
+    operator=(SmallVector&& other) noexcept
+    {
+        if (this != &other)
+        {
+            clear();
+            release();
+            alloc = other.alloc;
+            take(other);
+        }
+        return *this;
+    }
+
+    ~SmallVector()
+    {
+        clear();
+        release();
+    }
+
+
+    // Modifiers
+    //
+    /// reserve - grows the size by n value initialised elements.
+    /// Always succeeds, the bool return keeps the signature of Array::reserve.
+    bool
+    reserve(size_t n)
+    {
+        grow_to(last + n);
+        std::uninitialized_value_construct(container + last, container + last + n);
+        last += n;
+        return true;
+    }
+
+    bool
+    push_back(_Tp value)
+    {
+        grow_to(last + 1);
+        ::new (Cast(void*, container + last)) _Tp(std::move(value));
+        last += 1;
+        return true;
+    }
+
+    _Tp
+    pop_front(_Tp default_val)
+    {
+        if (last == 0)
+        {
+            return default_val;
+        }
+
+        _Tp value = std::move(CONTAINER[0]);
+        std::move(this->begin() + 1, this->end(), this->begin());
+        std::destroy_at(container + last - 1);
+        --last;
+        return value;
+    }
+
+    void
+    clear()
+    {
+        std::destroy(begin(), end());
+        last = 0;
+    }
+
+
+    // Iterators.
+    /// begin - a forward iterator starting at the first element of the container.
+    constexpr auto
+    begin() noexcept
+    {
+        return iterator(container);
+    }
+
+    constexpr auto
+    begin() const noexcept
+    {
+        return const_iterator(container);
+    }
+
+    constexpr auto
+    cbegin() const noexcept
+    {
+        return const_iterator(container);
+    }
+
+
+    /// end - a forward iterator that points past the last element of the container.
+    constexpr auto
+    end() noexcept
+    {
+        return iterator(container + last);
+    }
+
+    constexpr auto
+    end() const noexcept
+    {
+        return const_iterator(container + last);
+    }
+
+    constexpr auto
+    cend() const noexcept
+    {
+        return const_iterator(container + last);
+    }
+
+
+    // Capacity Functions.
+    //
+    constexpr size_t
+    size() const noexcept
+    {
+        return last;
+    }
+
+    constexpr size_t
+    capacity() const noexcept
+    {
+        return cap;
+    }
+
+    constexpr bool
+    empty() const noexcept
+    {
+        return size() == 0;
+    }
+
+    /// is_inline - true while the elements are still stored inside the SmallVector.
+    bool
+    is_inline() const noexcept
+    {
+        return container == inline_data();
+    }
+
+
+    // Access Functions.
+    //
+    reference
+    operator[](size_t pos)
+    {
+        assert(pos < last);
+        return CONTAINER[pos];
+    }
+
+    const_reference
+    operator[](size_t pos) const
+    {
+        assert(pos < last);
+        return CONTAINER[pos];
+    }
+
+
+    /// back - returns the element at the back of the container.
+    constexpr auto&
+    back() noexcept
+    {
+        return CONTAINER[last - 1];
+    }
+
+    constexpr auto&
+    back() const noexcept
+    {
+        return CONTAINER[last - 1];
+    }
+
+    constexpr auto&
+    cback() const noexcept
+    {
+        return CONTAINER[last - 1];
+    }
+
+
+    // Implementation.
+    //
+    _Tp*
+    inline_data() noexcept
+    {
+        return Cast(_Tp*, Cast(void*, buffer));
+    }
+
+    _Tp const*
+    inline_data() const noexcept
+    {
+        return Cast(_Tp const*, Cast(void const*, buffer));
+    }
+
+    /// grow_to - makes sure there is room for n elements, doubling the capacity when it spills.
+    void
+    grow_to(size_t n)
+    {
+        if (n <= cap)
+        {
+            return;
+        }
+
+        size_t new_cap  = std::max(n, cap * 2);
+        _Tp*   new_data = AllocTraits::allocate(alloc, new_cap);
+
+        std::uninitialized_move(begin(), end(), new_data);
+        std::destroy(begin(), end());
+        release();
+
+        container = new_data;
+        cap       = new_cap;
+    }
+
+    /// release - returns the spilled storage to the allocator. Elements must already be destroyed.
+    void
+    release() noexcept
+    {
+        if (!is_inline())
+        {
+            AllocTraits::deallocate(alloc, container, cap);
+            container = inline_data();
+            cap       = Nm;
+        }
+    }
+
+    /// take - moves the contents of other into this, which must be empty and inline.
+    void
+    take(SmallVector& other) noexcept
+    {
+        if (other.is_inline())
+        {
+            // NOTE: Copied between the inline buffers, bounded by Nm, so the
+            // compiler can see the copy never runs past either of them.
+            size_t n = std::min(other.last, Nm);
+            std::uninitialized_move_n(other.inline_data(), n, inline_data());
+            last = n;
+            other.clear();
+        }
+        else
+        {
+            container       = other.container;
+            cap             = other.cap;
+            last            = other.last;
+            other.container = other.inline_data();
+            other.cap       = Nm;
+            other.last      = 0;
+        }
+    }
+};
+
+#undef CONTAINER
@@ -0,0 +1,284 @@
+#pragma once
+
+#include "Base/dllexports.h"
+#include <cassert>
+#include <cstddef>
+#include <span>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+
+/// SoaRow - a proxy for one element of a SoaArray, giving access to each of its fields.
+template <typename SoaTp>
+struct SoaRow
+{
+    SoaTp* soa;
+    size_t index;
+
+    template <size_t I>
+    auto&
+    get() const noexcept
+    {
+        return std::get<I>(soa->columns).data[index];
+    }
+};
+
+
+/// SoaIterator - a random access iterator over a SoaArray yielding SoaRows.
+template <typename SoaTp>
+struct SoaIterator
+{
+    SoaTp* soa;
+    size_t index;
+
+    SoaRow<SoaTp>
+    operator*() const noexcept
+    {
+        return { soa, index };
+    }
+
+    SoaIterator&
+    operator++() noexcept
+    {
+        index += 1;
+        return *this;
+    }
+
+    SoaIterator
+    operator+(ptrdiff_t n) const noexcept
+    {
+        return { soa, index + n };
+    }
+
+    ptrdiff_t
+    operator-(SoaIterator const& other) const noexcept
+    {
+        return ptrdiff_t(index) - ptrdiff_t(other.index);
+    }
+
+    bool
+    operator==(SoaIterator const& other) const noexcept
+    {
+        return index == other.index;
+    }
+};
+
+
+/// SoaArray - a fixed capacity array that stores each field in its own
+/// contiguous column.
+///
+/// Fields are addressed by index, usually through an enum, e.g.
+///
+///     enum PositionField { Position_X, Position_Y };
+///     SoaArray<16, float, float> positions;
+///     positions.column<Position_X>()  // span over every x.
+///     auto [x, y] = positions[0];     // references into both columns.
+///
+/// Each column starts on a cache line so kernels can use aligned loads.
+template <size_t Nm, typename... Fields>
+struct SoaArray
+{
+    static constexpr size_t NUM_FIELDS = sizeof...(Fields);
+    static constexpr size_t ALIGNMENT  = 64;
+
+    template <size_t I>
+    using field_type = std::tuple_element_t<I, std::tuple<Fields...>>;
+
+    template <typename Tp>
+    struct alignas(ALIGNMENT) Column
+    {
+        Tp data[Nm];
+    };
+
+    typedef SoaRow<SoaArray>            Row;
+    typedef SoaRow<SoaArray const>      ConstRow;
+    typedef SoaIterator<SoaArray>       iterator;
+    typedef SoaIterator<SoaArray const> const_iterator;
+
+    // Data members
+    //
+    std::tuple<Column<Fields>...> columns;
+    size_t                        last { 0 };
+
+    // Modifiers
+    //
+    bool
+    reserve(size_t n)
+    {
+        auto size = last + n;
+        if (size > Nm)
+        {
+            return false;
+        }
+
+        last = size;
+        return true;
+    }
+
+    void
+    reserve_all()
+    {
+        last = Nm;
+    }
+
+    bool
+    push_back(Fields... values)
+    {
+        if (!reserve(1))
+        {
+            return false;
+        }
+
+        set_row(last - 1, std::index_sequence_for<Fields...> {}, std::move(values)...);
+        return true;
+    }
+
+    /// remove_swap - removes the element at pos by moving the last element into it.
+    void
+    remove_swap(size_t pos)
+    {
+        assert(pos < last);
+        move_row(last - 1, pos, std::index_sequence_for<Fields...> {});
+        last -= 1;
+    }
+
+    void
+    clear()
+    {
+        last = 0;
+    }
+
+
+    // Iterators.
+    //
+    iterator
+    begin() noexcept
+    {
+        return { this, 0 };
+    }
+
+    const_iterator
+    begin() const noexcept
+    {
+        return { this, 0 };
+    }
+
+    iterator
+    end() noexcept
+    {
+        return { this, last };
+    }
+
+    const_iterator
+    end() const noexcept
+    {
+        return { this, last };
+    }
+
+
+    // Capacity Functions.
+    //
+    constexpr size_t
+    size() const noexcept
+    {
+        return last;
+    }
+
+    constexpr size_t
+    capacity() const noexcept
+    {
+        return Nm;
+    }
+
+    constexpr bool
+    empty() const noexcept
+    {
+        return size() == 0;
+    }
+
+    constexpr bool
+    full() const noexcept
+    {
+        return size() == Nm;
+    }
+
+
+    // Access Functions.
+    //
+    Row
+    operator[](size_t pos) noexcept
+    {
+        assert(pos < Nm);
+        return { this, pos };
+    }
+
+    ConstRow
+    operator[](size_t pos) const noexcept
+    {
+        assert(pos < Nm);
+        return { this, pos };
+    }
+
+    /// column - the first size() elements of field I.
+    template <size_t I>
+    std::span<field_type<I>>
+    column() noexcept
+    {
+        return { std::get<I>(columns).data, last };
+    }
+
+    template <size_t I>
+    std::span<field_type<I> const>
+    column() const noexcept
+    {
+        return { std::get<I>(columns).data, last };
+    }
+
+    /// data - the aligned start of field I's column.
+    template <size_t I>
+    field_type<I>*
+    data() noexcept
+    {
+        return std::get<I>(columns).data;
+    }
+
+    template <size_t I>
+    field_type<I> const*
+    data() const noexcept
+    {
+        return std::get<I>(columns).data;
+    }
+
+
+    // Implementation.
+    //
+    template <size_t... Is>
+    void
+    set_row(size_t pos, std::index_sequence<Is...>, Fields&&... values)
+    {
+        ((std::get<Is>(columns).data[pos] = std::move(values)), ...);
+    }
+
+    template <size_t... Is>
+    void
+    move_row(size_t from, size_t to, std::index_sequence<Is...>)
+    {
+        ((std::get<Is>(columns).data[to] = std::move(std::get<Is>(columns).data[from])), ...);
+    }
+};
+
+
+// Allow rows to be unpacked with structured bindings, the bindings are
+// references into each column.
+template <typename SoaTp>
+struct std::tuple_size<SoaRow<SoaTp>>
+    : std::integral_constant<size_t, std::remove_const_t<SoaTp>::NUM_FIELDS>
+{
+};
+
+template <size_t I, typename SoaTp>
+struct std::tuple_element<I, SoaRow<SoaTp>>
+{
+    using type = decltype(std::declval<SoaRow<SoaTp>>().template get<I>());
+};
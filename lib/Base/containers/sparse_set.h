@@ -0,0 +1,202 @@
+#pragma once
+
+#include "Base/dllexports.h"
+#include "Base/typedefs.h"
+#include <cassert>
+#include <cstddef>
+#include <span>
+#include <utility>
+#include <vector>
+
+
+/// SparseSet - maps small integer keys, usually entity indices, to densely
+/// packed values.
+///
+/// sparse is indexed by key and holds the position of the key's value in
+/// dense, dense_keys holds the key of each value so erase can patch the
+/// element it moves into the hole. Insert, erase and lookup are O(1) and
+/// iterating the values is a linear scan over dense memory.
+///
+/// Keys are not generational, pair it with a SlotMap and key by
+/// SlotHandle::index to catch stale handles.
+template <typename _Tp>
+struct SparseSet
+{
+    typedef _Tp               value_type;
+    typedef value_type&       reference;
+    typedef const value_type& const_reference;
+    typedef value_type*       iterator;
+    typedef const value_type* const_iterator;
+
+    static constexpr uint32 INVALID_INDEX = UINT32_MAX;
+
+    // Data members
+    //
+    std::vector<_Tp>    dense;
+    std::vector<uint32> dense_keys;
+    std::vector<uint32> sparse;
+
+    // Modifiers.
+    //
+    /// insert - adds a value for key, or replaces the existing one. Returns the stored value.
+    _Tp&
+    insert(uint32 key, _Tp value = _Tp())
+    {
+        if (key >= sparse.size())
+        {
+            sparse.resize(key + 1, INVALID_INDEX);
+        }
+
+        if (sparse[key] != INVALID_INDEX)
+        {
+            return dense[sparse[key]] = std::move(value);
+        }
+
+        sparse[key] = Cast(uint32, dense.size());
+        dense.push_back(std::move(value));
+        dense_keys.push_back(key);
+        return dense.back();
+    }
+
+    /// erase - removes the value for key. Returns false if there is none.
+    bool
+    erase(uint32 key)
+    {
+        if (!contains(key))
+        {
+            return false;
+        }
+
+        uint32 hole = sparse[key];
+        uint32 back = Cast(uint32, dense.size() - 1);
+
+        if (hole != back)
+        {
+            dense[hole]      = std::move(dense[back]);
+            dense_keys[hole] = dense_keys[back];
+
+            sparse[dense_keys[hole]] = hole;
+        }
+        dense.pop_back();
+        dense_keys.pop_back();
+
+        sparse[key] = INVALID_INDEX;
+        return true;
+    }
+
+    void
+    clear()
+    {
+        for (auto key : dense_keys)
+        {
+            sparse[key] = INVALID_INDEX;
+        }
+        dense.clear();
+        dense_keys.clear();
+    }
+
+    /// reserve - makes room for n values and keys below max_key without reallocating.
+    void
+    reserve(size_t n, size_t max_key)
+    {
+        dense.reserve(n);
+        dense_keys.reserve(n);
+        if (max_key > sparse.size())
+        {
+            sparse.resize(max_key, INVALID_INDEX);
+        }
+    }
+
+
+    // Access Functions.
+    //
+    bool
+    contains(uint32 key) const noexcept
+    {
+        return key < sparse.size() && sparse[key] != INVALID_INDEX;
+    }
+
+    /// get - the value for key, or nullptr if there is none.
+    _Tp*
+    get(uint32 key) noexcept
+    {
+        return contains(key) ? &dense[sparse[key]] : nullptr;
+    }
+
+    _Tp const*
+    get(uint32 key) const noexcept
+    {
+        return contains(key) ? &dense[sparse[key]] : nullptr;
+    }
+
+    /// key_at - the key of the value at position pos of the dense storage.
+    uint32
+    key_at(size_t pos) const noexcept
+    {
+        assert(pos < dense.size());
+        return dense_keys[pos];
+    }
+
+    /// keys - the key of every value, in the same order as the values.
+    std::span<uint32 const>
+    keys() const noexcept
+    {
+        return dense_keys;
+    }
+
+    reference
+    operator[](size_t pos)
+    {
+        assert(pos < dense.size());
+        return dense[pos];
+    }
+
+    const_reference
+    operator[](size_t pos) const
+    {
+        assert(pos < dense.size());
+        return dense[pos];
+    }
+
+
+    // Iterators.
+    /// begin - a forward iterator over the dense values, in no particular order.
+    iterator
+    begin() noexcept
+    {
+        return dense.data();
+    }
+
+    const_iterator
+    begin() const noexcept
+    {
+        return dense.data();
+    }
+
+    iterator
+    end() noexcept
+    {
+        return dense.data() + dense.size();
+    }
+
+    const_iterator
+    end() const noexcept
+    {
+        return dense.data() + dense.size();
+    }
+
+
+    // Capacity Functions.
+    //
+    size_t
+    size() const noexcept
+    {
+        return dense.size();
+    }
+
+    bool
+    empty() const noexcept
+    {
+        return dense.empty();
+    }
+};
@@ -0,0 +1,307 @@
+#pragma once
+
+#include "Base/dllexports.h"
+#include "Base/platform/platform.h"
+#include "Base/typedefs.h"
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+#define CONTAINER (container)
+
+
+/// VirtualVector - a growable array backed by a reserved range of address space.
+///
+/// The whole range is reserved up front and pages are committed as the vector
+/// grows, so growing never copies or moves the existing elements and pointers
+/// to them stay valid until they are removed. The only limit is the size of
+/// the reservation.
+template <typename _Tp>
+struct VirtualVector
+{
+    typedef _Tp               value_type;
+    typedef value_type*       pointer;
+    typedef const value_type* const_pointer;
+    typedef value_type&       reference;
+    typedef const value_type& const_reference;
+    typedef value_type*       iterator;
+    typedef const value_type* const_iterator;
+    typedef ptrdiff_t         difference_type;
+
+    // NOTE: Commit in multiples of the Windows allocation granularity, which is
+    // also a multiple of the page size on every platform we support.
+    static constexpr uint64 COMMIT_GRANULARITY = Kilobytes(64);
+    static constexpr uint64 DEFAULT_RESERVE    = Gigabytes(4);
+
+    // Data members
+    //
+    _Tp*   container { nullptr };
+    size_t last { 0 };
+    uint64 committed_bytes { 0 };
+    uint64 reserved_bytes { 0 };
+
+    // Constructors.
+    explicit VirtualVector(uint64 reserve_bytes = DEFAULT_RESERVE)
+    {
+        reserved_bytes = RoundUp(reserve_bytes);
+        container      = Cast(_Tp*, Platform_ReserveVirtualMemory(reserved_bytes));
+    }
+
+    VirtualVector(VirtualVector const&) = delete;
+    VirtualVector&
+    operator=(VirtualVector const&) = delete;
+
+    VirtualVector(VirtualVector&& other) noexcept
+        : container(std::exchange(other.container, nullptr))
+        , last(std::exchange(other.last, 0))
+        , committed_bytes(std::exchange(other.committed_bytes, 0))
+        , reserved_bytes(std::exchange(other.reserved_bytes, 0))
+    {
+    }
+
+    VirtualVector&
+    operator=(VirtualVector&& other) noexcept
+    {
+        if (this != &other)
+        {
+            release();
+            container       = std::exchange(other.container, nullptr);
+            last            = std::exchange(other.last, 0);
+            committed_bytes = std::exchange(other.committed_bytes, 0);
+            reserved_bytes  = std::exchange(other.reserved_bytes, 0);
+        }
+        return *this;
+    }
+
+    ~VirtualVector()
+    {
+        release();
+    }
+
+
+    // Modifiers
+    //
+    /// reserve - grows the size by n value initialised elements, as Array::reserve does.
+    /// Returns false if the reservation is exhausted.
+    bool
+    reserve(size_t n)
+    {
+        if (!commit(last + n))
+        {
+            return false;
+        }
+
+        std::uninitialized_value_construct(container + last, container + last + n);
+        last += n;
+        return true;
+    }
+
+    bool
+    push_back(_Tp value)
+    {
+        return emplace_back(std::move(value)) != nullptr;
+    }
+
+    /// emplace_back - constructs an element at the back, returns nullptr if the reservation is exhausted.
+    template <typename... Args>
+    _Tp*
+    emplace_back(Args&&... args)
+    {
+        if (!commit(last + 1))
+        {
+            return nullptr;
+        }
+
+        auto* item = ::new (Cast(void*, container + last)) _Tp(std::forward<Args>(args)...);
+        last += 1;
+        return item;
+    }
+
+    void
+    pop_back()
+    {
+        assert(last > 0);
+        last -= 1;
+        std::destroy_at(container + last);
+    }
+
+    /// remove_swap - removes the element at pos by moving the back element into it.
+    void
+    remove_swap(size_t pos)
+    {
+        assert(pos < last);
+        if (pos != last - 1)
+        {
+            CONTAINER[pos] = std::move(CONTAINER[last - 1]);
+        }
+        pop_back();
+    }
+
+    /// clear - destroys every element. Committed pages are kept for reuse.
+    void
+    clear()
+    {
+        std::destroy(begin(), end());
+        last = 0;
+    }
+
+
+    // Iterators.
+    /// begin - a forward iterator starting at the first element of the container.
+    constexpr auto
+    begin() noexcept
+    {
+        return iterator(container);
+    }
+
+    constexpr auto
+    begin() const noexcept
+    {
+        return const_iterator(container);
+    }
+
+    constexpr auto
+    cbegin() const noexcept
+    {
+        return const_iterator(container);
+    }
+
+
+    /// end - a forward iterator that points past the last element of the container.
+    constexpr auto
+    end() noexcept
+    {
+        return iterator(container + last);
+    }
+
+    constexpr auto
+    end() const noexcept
+    {
+        return const_iterator(container + last);
+    }
+
+    constexpr auto
+    cend() const noexcept
+    {
+        return const_iterator(container + last);
+    }
+
+
+    // Capacity Functions.
+    //
+    constexpr size_t
+    size() const noexcept
+    {
+        return last;
+    }
+
+    /// capacity - the number of elements that fit in the reservation.
+    constexpr size_t
+    capacity() const noexcept
+    {
+        return reserved_bytes / sizeof(_Tp);
+    }
+
+    constexpr bool
+    empty() const noexcept
+    {
+        return size() == 0;
+    }
+
+    constexpr bool
+    full() const noexcept
+    {
+        return size() == capacity();
+    }
+
+
+    // Access Functions.
+    //
+    reference
+    operator[](size_t pos)
+    {
+        assert(pos < last);
+        return CONTAINER[pos];
+    }
+
+    const_reference
+    operator[](size_t pos) const
+    {
+        assert(pos < last);
+        return CONTAINER[pos];
+    }
+
+    pointer
+    data() noexcept
+    {
+        return container;
+    }
+
+    const_pointer
+    data() const noexcept
+    {
+        return container;
+    }
+
+
+    /// back - returns the element at the back of the container.
+    constexpr auto&
+    back() noexcept
+    {
+        return CONTAINER[last - 1];
+    }
+
+    constexpr auto&
+    back() const noexcept
+    {
+        return CONTAINER[last - 1];
+    }
+
+
+    // Implementation.
+    //
+    static constexpr uint64
+    RoundUp(uint64 bytes)
+    {
+        return (bytes + COMMIT_GRANULARITY - 1) & ~(COMMIT_GRANULARITY - 1);
+    }
+
+    /// commit - makes sure the pages for the first n elements are committed.
+    bool
+    commit(size_t n)
+    {
+        uint64 needed = sizeof(_Tp) * n;
+        if (needed <= committed_bytes)
+        {
+            return true;
+        }
+        if (needed > reserved_bytes)
+        {
+            return false;
+        }
+
+        uint64 target = RoundUp(needed);
+        if (!Platform_CommitVirtualMemory(Cast(UByte*, Cast(void*, container)) + committed_bytes,
+                                          target - committed_bytes))
+        {
+            return false;
+        }
+
+        committed_bytes = target;
+        return true;
+    }
+
+    void
+    release() noexcept
+    {
+        if (container)
+        {
+            clear();
+            Platform_FreeVirtualMemory(container, reserved_bytes);
+            container = nullptr;
+        }
+    }
+};
+
+#undef CONTAINER
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "Base/containers/fixed_map.h"
 #include "Base/dllexports.h"
 #include "Base/platform/platform.h"
 #include "Base/typedefs.h"
@@ -7,7 +8,6 @@
 #include <atomic>
 #include <cassert>
 #include <limits.h>
-#include <map>
 #include <stdio.h>
 
 #ifdef DEBUG_BUILD
@@ -29,7 +29,9 @@ struct Debug_TimeBlockRecord
 
 public_struct Debug_TimeBlockStore
 {
-    using FileToRecordsMap = std::map<char const*, std::array<Debug_TimeBlockRecord, 128>>;
+    // NOTE: Keyed on the __FILE__ pointer, so each translation unit that uses
+    // TIME_BLOCK takes one entry.
+    using FileToRecordsMap = FixedMap<char const*, std::array<Debug_TimeBlockRecord, 128>, 128>;
 
     FileToRecordsMap file_name_to_records_map;
 };
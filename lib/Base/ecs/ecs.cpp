@@ -0,0 +1,524 @@
+#include "Base/ecs/ecs.h"
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+
+
+static std::array<EcsComponentInfo, ECS_MAX_COMPONENTS> global_component_registry;
+static std::atomic<uint32>                              global_component_count { 0 };
+static std::atomic<uint64>                              global_next_world_id { 1 };
+
+
+EcsComponentType
+Ecs_RegisterComponent(EcsComponentInfo const& info)
+{
+    uint32 type = global_component_count.fetch_add(1);
+    assert(type < ECS_MAX_COMPONENTS);
+
+    global_component_registry[type] = info;
+    return type;
+}
+
+EcsComponentInfo const&
+Ecs_GetComponentInfo(EcsComponentType type)
+{
+    assert(type < global_component_count);
+    return global_component_registry[type];
+}
+
+uint32
+Ecs_ComponentTypeCount()
+{
+    return global_component_count;
+}
+
+
+//////////////////////////////////////////////////////////////////////////////
+
+
+static uint32
+AlignUp(uint32 value, uint32 align)
+{
+    return (value + (align - 1)) & ~(align - 1);
+}
+
+static inline void*
+Ecs_ComponentAt(EcsArchetype const& archetype, EcsLocation location, EcsComponentType type)
+{
+    UByte* data = archetype.chunks[location.chunk].data;
+    return data + archetype.column_offsets[type] + (location.row * Ecs_GetComponentInfo(type).size);
+}
+
+static inline EcsEntity&
+Ecs_EntityAt(EcsArchetype& archetype, EcsLocation location)
+{
+    return EcsChunk_Entities(archetype.chunks[location.chunk])[location.row];
+}
+
+
+/// EcsChunk_Touch - marks every column of the chunk as changed, for when rows
+/// are added to it or moved around in it.
+static inline void
+EcsChunk_Touch(EcsWorld const& world, EcsArchetype const& archetype, EcsChunk& chunk)
+{
+    uint32 tick = Ecs_ChangeTick(world);
+    for (auto type : archetype.types)
+    {
+        EcsChunk_MarkChanged(chunk, type, tick);
+    }
+}
+
+
+/// Ecs_AllocateRow - appends an uninitialised row to the archetype.
+static EcsLocation
+Ecs_AllocateRow(EcsWorld& world, EcsArchetype& archetype)
+{
+    if (archetype.chunks.empty() || archetype.chunks.back().count == archetype.chunk_capacity)
+    {
+        archetype.chunks.push_back({ Ecs_AllocateChunk(world), 0 });
+    }
+
+    EcsChunk& chunk = archetype.chunks.back();
+    uint32    row   = chunk.count;
+
+    // NOTE: Bump the count first so EcsChunk_Entities covers the new row.
+    chunk.count += 1;
+    archetype.entity_count += 1;
+    EcsChunk_Touch(world, archetype, chunk);
+    return { archetype.index, Cast(uint32, archetype.chunks.size() - 1), row };
+}
+
+
+/// Ecs_FreeRow - removes a row whose components have already been destroyed or
+/// relocated, by relocating the last row of the archetype into it.
+static void
+Ecs_FreeRow(EcsWorld& world, EcsArchetype& archetype, EcsLocation hole)
+{
+    uint32      last_chunk_idx = Cast(uint32, archetype.chunks.size() - 1);
+    EcsChunk&   last_chunk     = archetype.chunks[last_chunk_idx];
+    EcsLocation last { archetype.index, last_chunk_idx, last_chunk.count - 1 };
+
+    if (hole.chunk != last.chunk || hole.row != last.row)
+    {
+        for (auto type : archetype.types)
+        {
+            Ecs_GetComponentInfo(type).relocate(Ecs_ComponentAt(archetype, hole, type),
+                                                Ecs_ComponentAt(archetype, last, type),
+                                                1);
+        }
+
+        EcsEntity moved               = Ecs_EntityAt(archetype, last);
+        Ecs_EntityAt(archetype, hole) = moved;
+        *world.entities.get(moved)    = hole;
+        EcsChunk_Touch(world, archetype, archetype.chunks[hole.chunk]);
+    }
+
+    last_chunk.count -= 1;
+    archetype.entity_count -= 1;
+
+    if (last_chunk.count == 0)
+    {
+        Ecs_FreeChunk(world, last_chunk.data);
+        archetype.chunks.pop_back();
+    }
+}
+
+
+/// Ecs_MoveEntity - moves the entity's row to dst, keeping the components both archetypes share.
+static EcsLocation
+Ecs_MoveEntity(EcsWorld& world, EcsEntity entity, EcsArchetype& dst)
+{
+    EcsLocation   src_location = *world.entities.get(entity);
+    EcsArchetype& src          = *world.archetypes[src_location.archetype];
+    EcsLocation   dst_location = Ecs_AllocateRow(world, dst);
+
+    for (auto type : dst.types)
+    {
+        auto const& info = Ecs_GetComponentInfo(type);
+        void*       to   = Ecs_ComponentAt(dst, dst_location, type);
+
+        if (EcsArchetype_Has(src, type))
+        {
+            info.relocate(to, Ecs_ComponentAt(src, src_location, type), 1);
+        }
+        else
+        {
+            info.construct(to, 1);
+        }
+    }
+
+    for (auto type : src.types)
+    {
+        if (!EcsArchetype_Has(dst, type))
+        {
+            Ecs_GetComponentInfo(type).destroy(Ecs_ComponentAt(src, src_location, type), 1);
+        }
+    }
+
+    Ecs_EntityAt(dst, dst_location) = entity;
+    Ecs_FreeRow(world, src, src_location);
+
+    *world.entities.get(entity) = dst_location;
+    return dst_location;
+}
+
+
+//////////////////////////////////////////////////////////////////////////////
+
+
+EcsWorld::EcsWorld()
+    : id(global_next_world_id.fetch_add(1, std::memory_order_relaxed))
+{
+}
+
+
+EcsWorld::~EcsWorld()
+{
+    Ecs_Clear(*this);
+    for (auto* data : free_chunks)
+    {
+        ::operator delete(data, std::align_val_t(ECS_COLUMN_ALIGNMENT));
+    }
+}
+
+
+UByte*
+Ecs_AllocateChunk(EcsWorld& world)
+{
+    if (!world.free_chunks.empty())
+    {
+        UByte* data = world.free_chunks.back();
+        world.free_chunks.pop_back();
+        return data;
+    }
+    return Cast(UByte*, ::operator new(ECS_CHUNK_SIZE, std::align_val_t(ECS_COLUMN_ALIGNMENT)));
+}
+
+
+void
+Ecs_FreeChunk(EcsWorld& world, UByte* data)
+{
+    world.free_chunks.push_back(data);
+}
+
+
+EcsArchetype*
+Ecs_GetArchetype(EcsWorld& world, EcsComponentMask const& mask)
+{
+    if (auto* index = world.archetype_lookup.find(mask.words[0]))
+    {
+        return world.archetypes[*index].get();
+    }
+
+    auto archetype   = std::make_unique<EcsArchetype>();
+    archetype->mask  = mask;
+    archetype->index = Cast(uint32, world.archetypes.size());
+    archetype->column_offsets.fill(ECS_NO_COLUMN);
+    archetype->add_edges.fill(ECS_NO_EDGE);
+    archetype->remove_edges.fill(ECS_NO_EDGE);
+
+    for (auto type : mask)
+    {
+        archetype->types.push_back(Cast(EcsComponentType, type));
+    }
+    archetype->chunk_capacity = Ecs_ChunkCapacity(mask);
+    assert(archetype->chunk_capacity > 0);
+
+    uint32 offset = archetype->chunk_capacity * sizeof(EcsEntity);
+    for (auto type : archetype->types)
+    {
+        offset                          = AlignUp(offset, ECS_COLUMN_ALIGNMENT);
+        archetype->column_offsets[type] = offset;
+        offset += archetype->chunk_capacity * Ecs_GetComponentInfo(type).size;
+    }
+    assert(offset <= ECS_CHUNK_SIZE);
+
+    [[maybe_unused]] auto* inserted
+        = world.archetype_lookup.insert(mask.words[0], archetype->index);
+    assert(inserted);
+
+    world.archetypes.push_back(std::move(archetype));
+    world.structure_version += 1;
+    return world.archetypes.back().get();
+}
+
+
+uint32
+Ecs_ChunkCapacity(EcsComponentMask const& mask)
+{
+    uint32 row_size = sizeof(EcsEntity);
+    for (auto type : mask)
+    {
+        row_size += Ecs_GetComponentInfo(type).size;
+    }
+
+    // Leave room for every column to be padded out to a cache line.
+    uint32 padding = Cast(uint32, (mask.count() + 1) * ECS_COLUMN_ALIGNMENT);
+    return (ECS_CHUNK_SIZE - padding) / row_size;
+}
+
+
+EcsEntity
+Ecs_Create(EcsWorld& world, EcsComponentMask const& mask)
+{
+    EcsArchetype& archetype = *Ecs_GetArchetype(world, mask);
+    EcsLocation   location  = Ecs_AllocateRow(world, archetype);
+
+    for (auto type : archetype.types)
+    {
+        Ecs_GetComponentInfo(type).construct(Ecs_ComponentAt(archetype, location, type), 1);
+    }
+
+    EcsEntity entity                  = world.entities.insert(location);
+    Ecs_EntityAt(archetype, location) = entity;
+    return entity;
+}
+
+
+/// Ecs_CreateRows - appends out.size() rows to the archetype a chunk at a time,
+/// calling init(type, info, dst, n) to construct the n new rows of each column.
+template <typename Fn>
+static void
+Ecs_CreateRows(EcsWorld& world, EcsArchetype& archetype, std::span<EcsEntity> out, Fn&& init)
+{
+    world.entities.reserve(world.entities.size() + out.size());
+
+    size_t done = 0;
+    while (done < out.size())
+    {
+        if (archetype.chunks.empty() || archetype.chunks.back().count == archetype.chunk_capacity)
+        {
+            archetype.chunks.push_back({ Ecs_AllocateChunk(world), 0 });
+        }
+
+        uint32    chunk_idx = Cast(uint32, archetype.chunks.size() - 1);
+        EcsChunk& chunk     = archetype.chunks.back();
+        uint32    first     = chunk.count;
+        size_t    room      = archetype.chunk_capacity - first;
+        uint32    n         = Cast(uint32, std::min(room, out.size() - done));
+
+        // Fill each column's new rows with one call.
+        for (auto type : archetype.types)
+        {
+            auto const& info = Ecs_GetComponentInfo(type);
+            init(type, info, chunk.data + archetype.column_offsets[type] + (first * info.size), n);
+        }
+
+        chunk.count += n;
+        archetype.entity_count += n;
+        EcsChunk_Touch(world, archetype, chunk);
+
+        auto entities = EcsChunk_Entities(chunk);
+        for (uint32 i = 0; i < n; ++i)
+        {
+            EcsEntity entity    = world.entities.insert({ archetype.index, chunk_idx, first + i });
+            entities[first + i] = entity;
+            out[done + i]       = entity;
+        }
+        done += n;
+    }
+}
+
+
+void
+Ecs_CreateMany(EcsWorld& world, EcsComponentMask const& mask, std::span<EcsEntity> out)
+{
+    auto construct = [](EcsComponentType, EcsComponentInfo const& info, void* dst, uint32 n) {
+        info.construct(dst, n);
+    };
+    Ecs_CreateRows(world, *Ecs_GetArchetype(world, mask), out, construct);
+}
+
+
+void
+Ecs_CreateManyFrom(EcsWorld&               world,
+                   EcsComponentMask const& mask,
+                   void const* const*      values,
+                   std::span<EcsEntity>    out)
+{
+    auto fill = [&](EcsComponentType type, EcsComponentInfo const& info, void* dst, uint32 n) {
+        if (!values[type])
+        {
+            info.construct(dst, n);
+        }
+        else
+        {
+            assert(info.fill && "the components of a prefab must be copyable");
+            info.fill(dst, values[type], n);
+        }
+    };
+    Ecs_CreateRows(world, *Ecs_GetArchetype(world, mask), out, fill);
+}
+
+
+bool
+Ecs_Destroy(EcsWorld& world, EcsEntity entity)
+{
+    EcsLocation* location = world.entities.get(entity);
+    if (!location)
+    {
+        return false;
+    }
+
+    EcsArchetype& archetype = *world.archetypes[location->archetype];
+    for (auto type : archetype.types)
+    {
+        Ecs_GetComponentInfo(type).destroy(Ecs_ComponentAt(archetype, *location, type), 1);
+    }
+
+    Ecs_FreeRow(world, archetype, *location);
+    world.entities.erase(entity);
+    return true;
+}
+
+
+bool
+Ecs_IsAlive(EcsWorld const& world, EcsEntity entity)
+{
+    return world.entities.contains(entity);
+}
+
+
+void*
+Ecs_GetComponent(EcsWorld& world, EcsEntity entity, EcsComponentType type)
+{
+    EcsLocation* location = world.entities.get(entity);
+    if (!location)
+    {
+        return nullptr;
+    }
+
+    EcsArchetype& archetype = *world.archetypes[location->archetype];
+    if (!EcsArchetype_Has(archetype, type))
+    {
+        return nullptr;
+    }
+
+    EcsChunk_MarkChanged(archetype.chunks[location->chunk], type, Ecs_ChangeTick(world));
+    return Ecs_ComponentAt(archetype, *location, type);
+}
+
+
+void const*
+Ecs_ReadComponent(EcsWorld const& world, EcsEntity entity, EcsComponentType type)
+{
+    EcsLocation const* location = world.entities.get(entity);
+    if (!location)
+    {
+        return nullptr;
+    }
+
+    EcsArchetype const& archetype = *world.archetypes[location->archetype];
+    if (!EcsArchetype_Has(archetype, type))
+    {
+        return nullptr;
+    }
+    return Ecs_ComponentAt(archetype, *location, type);
+}
+
+
+void*
+Ecs_AddComponent(EcsWorld& world, EcsEntity entity, EcsComponentType type)
+{
+    EcsLocation* location = world.entities.get(entity);
+    if (!location)
+    {
+        return nullptr;
+    }
+
+    EcsArchetype* src = world.archetypes[location->archetype].get();
+    if (EcsArchetype_Has(*src, type))
+    {
+        EcsChunk_MarkChanged(src->chunks[location->chunk], type, Ecs_ChangeTick(world));
+        return Ecs_ComponentAt(*src, *location, type);
+    }
+
+    if (src->add_edges[type] == ECS_NO_EDGE)
+    {
+        EcsComponentMask mask = src->mask;
+        mask.set(type);
+
+        EcsArchetype* dst       = Ecs_GetArchetype(world, mask);
+        src->add_edges[type]    = dst->index;
+        dst->remove_edges[type] = src->index;
+    }
+
+    EcsArchetype& dst          = *world.archetypes[src->add_edges[type]];
+    EcsLocation   dst_location = Ecs_MoveEntity(world, entity, dst);
+    return Ecs_ComponentAt(dst, dst_location, type);
+}
+
+
+bool
+Ecs_RemoveComponent(EcsWorld& world, EcsEntity entity, EcsComponentType type)
+{
+    EcsLocation* location = world.entities.get(entity);
+    if (!location)
+    {
+        return false;
+    }
+
+    EcsArchetype* src = world.archetypes[location->archetype].get();
+    if (!EcsArchetype_Has(*src, type))
+    {
+        return false;
+    }
+
+    if (src->remove_edges[type] == ECS_NO_EDGE)
+    {
+        EcsComponentMask mask = src->mask;
+        mask.reset(type);
+
+        EcsArchetype* dst       = Ecs_GetArchetype(world, mask);
+        src->remove_edges[type] = dst->index;
+        dst->add_edges[type]    = src->index;
+    }
+
+    Ecs_MoveEntity(world, entity, *world.archetypes[src->remove_edges[type]]);
+    return true;
+}
+
+
+bool
+Ecs_ChangeComponents(EcsWorld& world, EcsEntity entity, EcsComponentMask const& mask)
+{
+    EcsLocation* location = world.entities.get(entity);
+    if (!location)
+    {
+        return false;
+    }
+
+    if (world.archetypes[location->archetype]->mask != mask)
+    {
+        Ecs_MoveEntity(world, entity, *Ecs_GetArchetype(world, mask));
+    }
+    return true;
+}
+
+
+void
+Ecs_Clear(EcsWorld& world)
+{
+    for (auto& archetype : world.archetypes)
+    {
+        for (auto& chunk : archetype->chunks)
+        {
+            for (auto type : archetype->types)
+            {
+                Ecs_GetComponentInfo(type).destroy(EcsChunk_ColumnData(*archetype, chunk, type), chunk.count);
+            }
+            Ecs_FreeChunk(world, chunk.data);
+        }
+        archetype->chunks.clear();
+        archetype->entity_count = 0;
+    }
+
+    world.entities.clear();
+}
+
+
+size_t
+Ecs_EntityCount(EcsWorld const& world)
+{
+    return world.entities.size();
+}
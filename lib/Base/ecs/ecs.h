@@ -0,0 +1,486 @@
+#pragma once
+
+#include "Base/containers/bitset.h"
+#include "Base/containers/fixed_map.h"
+#include "Base/containers/slot_map.h"
+#include "Base/containers/small_vector.h"
+#include "Base/dllexports.h"
+#include "Base/typedefs.h"
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <span>
+#include <tuple>
+#include <type_traits>
+#include <typeinfo>
+#include <utility>
+#include <vector>
+
+
+//////////////////////////////////////////////////////////////////////////////
+//
+// An archetype based entity component system.
+//
+// Entities with the same set of components share an archetype, which stores
+// them in fixed size chunks. Each chunk holds one column per component plus a
+// column of entity handles, every column starts on a cache line and the rows
+// of a chunk are kept packed. A system that wants Position and Velocity visits
+// only the archetypes that have both and streams through their columns.
+//
+// Adding or removing a component moves the entity to another archetype, so
+// structural changes are more expensive than reads and writes.
+//
+// Each chunk records the change tick at which each of its columns was last
+// written, so a system can skip the chunks nothing has changed in since it
+// last ran. Writes are tracked a column of a chunk at a time, when a column
+// is handed out for writing, not per entity or per actual change.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+
+constexpr size_t ECS_MAX_COMPONENTS   = 64;
+constexpr size_t ECS_CHUNK_SIZE       = Kilobytes(16);
+constexpr size_t ECS_COLUMN_ALIGNMENT = 64;
+
+constexpr uint32 ECS_NO_COLUMN = UINT32_MAX;
+constexpr uint32 ECS_NO_EDGE   = UINT32_MAX;
+
+using EcsEntity        = SlotHandle;
+using EcsComponentType = uint32;
+using EcsComponentMask = BitSet<ECS_MAX_COMPONENTS>;
+
+static_assert(EcsComponentMask::NUM_WORDS == 1, "archetype lookup keys on a single mask word.");
+
+
+/// EcsComponentInfo - how to lay out and manage a component type without knowing it.
+struct EcsComponentInfo
+{
+    char const* name;
+    uint32      size;
+    uint32      align;
+    bool        trivially_copyable;
+
+    // Value initialises n components at dst.
+    void (*construct)(void* dst, size_t n);
+    // Move constructs n components at dst from src, then destroys the ones at src.
+    void (*relocate)(void* dst, void* src, size_t n);
+    void (*destroy)(void* dst, size_t n);
+    // Copy constructs n components at dst from src, nullptr if Tp can't be copied.
+    void (*copy)(void* dst, void const* src, size_t n);
+    // Copy constructs n components at dst from the one at value, nullptr if Tp can't be copied.
+    void (*fill)(void* dst, void const* value, size_t n);
+};
+
+
+template <typename Tp>
+EcsComponentInfo
+EcsComponentInfo_Make(char const* name)
+{
+    static_assert(alignof(Tp) <= ECS_COLUMN_ALIGNMENT);
+
+    EcsComponentInfo info;
+    info.name               = name;
+    info.size               = sizeof(Tp);
+    info.align              = alignof(Tp);
+    info.trivially_copyable = std::is_trivially_copyable_v<Tp>;
+    info.construct          = [](void* dst, size_t n) {
+        std::uninitialized_value_construct_n(Cast(Tp*, dst), n);
+    };
+    info.relocate = [](void* dst, void* src, size_t n) {
+        std::uninitialized_move_n(Cast(Tp*, src), n, Cast(Tp*, dst));
+        std::destroy_n(Cast(Tp*, src), n);
+    };
+    info.destroy = [](void* dst, size_t n) {
+        std::destroy_n(Cast(Tp*, dst), n);
+    };
+    info.copy = nullptr;
+    info.fill = nullptr;
+    if constexpr (std::is_copy_constructible_v<Tp>)
+    {
+        info.copy = [](void* dst, void const* src, size_t n) {
+            std::uninitialized_copy_n(Cast(Tp const*, src), n, Cast(Tp*, dst));
+        };
+        info.fill = [](void* dst, void const* value, size_t n) {
+            std::uninitialized_fill_n(Cast(Tp*, dst), n, *Cast(Tp const*, value));
+        };
+    }
+    return info;
+}
+
+
+/// Ecs_RegisterComponent - adds a component type to the global registry and returns its id.
+public_func EcsComponentType
+Ecs_RegisterComponent(EcsComponentInfo const& info);
+
+public_func EcsComponentInfo const&
+Ecs_GetComponentInfo(EcsComponentType type);
+
+public_func uint32
+Ecs_ComponentTypeCount();
+
+
+/// Ecs_TypeId - the id of component type Tp, registered the first time it is asked for.
+/// Tp and Tp const share an id.
+template <typename Tp>
+EcsComponentType
+Ecs_TypeId()
+{
+    if constexpr (std::is_const_v<Tp>)
+    {
+        return Ecs_TypeId<std::remove_const_t<Tp>>();
+    }
+    else
+    {
+        static EcsComponentType const id = Ecs_RegisterComponent(EcsComponentInfo_Make<Tp>(typeid(Tp).name()));
+        return id;
+    }
+}
+
+/// Ecs_Mask - the mask with the bit of each of Tps set.
+template <typename... Tps>
+EcsComponentMask
+Ecs_Mask()
+{
+    EcsComponentMask mask;
+    (mask.set(Ecs_TypeId<Tps>()), ...);
+    return mask;
+}
+
+/// Ecs_ReadMask - the mask of the Tps that are const, the components only read.
+template <typename... Tps>
+EcsComponentMask
+Ecs_ReadMask()
+{
+    EcsComponentMask mask;
+    ([&] {
+        if constexpr (std::is_const_v<Tps>)
+        {
+            mask.set(Ecs_TypeId<Tps>());
+        }
+    }(),
+     ...);
+    return mask;
+}
+
+/// Ecs_WriteMask - the mask of the Tps that aren't const.
+template <typename... Tps>
+EcsComponentMask
+Ecs_WriteMask()
+{
+    EcsComponentMask mask;
+    ([&] {
+        if constexpr (!std::is_const_v<Tps>)
+        {
+            mask.set(Ecs_TypeId<Tps>());
+        }
+    }(),
+     ...);
+    return mask;
+}
+
+
+//////////////////////////////////////////////////////////////////////////////
+
+
+/// EcsChunk - ECS_CHUNK_SIZE bytes holding up to chunk_capacity rows of one archetype.
+struct EcsChunk
+{
+    UByte* data;
+    uint32 count;
+
+    // The change tick each component's column was last written at, by type.
+    std::array<uint32, ECS_MAX_COMPONENTS> versions {};
+};
+
+
+public_struct EcsArchetype
+{
+    EcsComponentMask                  mask;
+    SmallVector<EcsComponentType, 16> types;
+    std::vector<EcsChunk>             chunks;
+    uint32                            index;
+    uint32                            chunk_capacity;
+    uint32                            entity_count { 0 };
+
+    // Byte offset of each component's column within a chunk, ECS_NO_COLUMN if
+    // the archetype doesn't have it. The entity column is always at 0.
+    std::array<uint32, ECS_MAX_COMPONENTS> column_offsets;
+
+    // Archetypes reached by adding or removing one component, filled in lazily.
+    std::array<uint32, ECS_MAX_COMPONENTS> add_edges;
+    std::array<uint32, ECS_MAX_COMPONENTS> remove_edges;
+};
+
+
+/// EcsLocation - where an entity's row lives.
+struct EcsLocation
+{
+    uint32 archetype;
+    uint32 chunk;
+    uint32 row;
+};
+
+
+public_struct EcsWorld
+{
+    SlotMap<EcsLocation>                       entities;
+    std::vector<std::unique_ptr<EcsArchetype>> archetypes;
+    FixedMap<uint64, uint32, 1024>             archetype_lookup;
+    std::vector<UByte*>                        free_chunks;
+
+    // Bumped every time an archetype is created, so anything caching the set
+    // of matching archetypes knows when to look again.
+    uint64 structure_version { 0 };
+
+    // Stamped on the columns written, see Ecs_AdvanceTick.
+    std::atomic<uint32> change_tick { 1 };
+
+    // Unique to this world and never reused, unlike its address, so a cache
+    // keyed on it can't mistake a new world for one that has been destroyed.
+    uint64 const id;
+
+    EcsWorld();
+    EcsWorld(EcsWorld const&) = delete;
+    EcsWorld&
+    operator=(EcsWorld const&) = delete;
+    ~EcsWorld();
+};
+
+
+//////////////////////////////////////////////////////////////////////////////
+
+
+/// Ecs_AllocateChunk - ECS_CHUNK_SIZE bytes for a chunk, reusing a free one if there is one.
+public_func UByte*
+Ecs_AllocateChunk(EcsWorld& world);
+
+/// Ecs_FreeChunk - keeps the chunk's data for reuse, its rows must be destroyed already.
+public_func void
+Ecs_FreeChunk(EcsWorld& world, UByte* data);
+
+/// Ecs_GetArchetype - the archetype for mask, created if it doesn't exist yet.
+public_func EcsArchetype*
+Ecs_GetArchetype(EcsWorld& world, EcsComponentMask const& mask);
+
+/// Ecs_ChunkCapacity - the rows each chunk of the archetype for mask holds.
+public_func uint32
+Ecs_ChunkCapacity(EcsComponentMask const& mask);
+
+/// Ecs_Create - creates an entity with a value initialised component for every bit of mask.
+public_func EcsEntity
+Ecs_Create(EcsWorld& world, EcsComponentMask const& mask);
+
+/// Ecs_CreateMany - creates out.size() entities with the components in mask, filling
+/// whole column ranges of each chunk at a time.
+public_func void
+Ecs_CreateMany(EcsWorld& world, EcsComponentMask const& mask, std::span<EcsEntity> out);
+
+/// Ecs_CreateManyFrom - Ecs_CreateMany, but each new entity's component of type is
+/// copied from values[type], or value initialised if that is nullptr. values has an
+/// entry for each of the ECS_MAX_COMPONENTS types, see EcsPrefab.
+public_func void
+Ecs_CreateManyFrom(EcsWorld&               world,
+                   EcsComponentMask const& mask,
+                   void const* const*      values,
+                   std::span<EcsEntity>    out);
+
+/// Ecs_Destroy - destroys the entity and its components. Returns false if the entity is stale.
+public_func bool
+Ecs_Destroy(EcsWorld& world, EcsEntity entity);
+
+public_func bool
+Ecs_IsAlive(EcsWorld const& world, EcsEntity entity);
+
+/// Ecs_GetComponent - the entity's component of type, or nullptr if it has none or is stale.
+/// Marks the component's column of the entity's chunk as changed.
+public_func void*
+Ecs_GetComponent(EcsWorld& world, EcsEntity entity, EcsComponentType type);
+
+/// Ecs_ReadComponent - Ecs_GetComponent for reading, doesn't mark anything as changed.
+public_func void const*
+Ecs_ReadComponent(EcsWorld const& world, EcsEntity entity, EcsComponentType type);
+
+/// Ecs_AddComponent - gives the entity a value initialised component of type and returns it.
+/// Returns the existing component if it already has one, nullptr if the entity is stale.
+public_func void*
+Ecs_AddComponent(EcsWorld& world, EcsEntity entity, EcsComponentType type);
+
+/// Ecs_RemoveComponent - returns false if the entity is stale or doesn't have the component.
+public_func bool
+Ecs_RemoveComponent(EcsWorld& world, EcsEntity entity, EcsComponentType type);
+
+/// Ecs_ChangeComponents - gives the entity exactly the components in mask in one move,
+/// value initialising the ones it gains. Returns false if the entity is stale.
+public_func bool
+Ecs_ChangeComponents(EcsWorld& world, EcsEntity entity, EcsComponentMask const& mask);
+
+/// Ecs_Clear - destroys every entity. Archetypes and their chunks are kept for reuse.
+public_func void
+Ecs_Clear(EcsWorld& world);
+
+public_func size_t
+Ecs_EntityCount(EcsWorld const& world);
+
+
+//////////////////////////////////////////////////////////////////////////////
+
+
+/// Ecs_ChangeTick - the tick writes are being stamped with.
+inline uint32
+Ecs_ChangeTick(EcsWorld const& world)
+{
+    return world.change_tick.load(std::memory_order_relaxed);
+}
+
+/// Ecs_AdvanceTick - starts a new change tick and returns the one before it.
+///
+/// Anything that wants to know what changed since it last looked calls this,
+/// looks for columns stamped after the tick it got last time, and remembers
+/// the one it got now. Writes made after the call are stamped with a later
+/// tick, so the next look finds them.
+inline uint32
+Ecs_AdvanceTick(EcsWorld& world)
+{
+    return world.change_tick.fetch_add(1, std::memory_order_relaxed);
+}
+
+inline void
+EcsChunk_MarkChanged(EcsChunk& chunk, EcsComponentType type, uint32 tick)
+{
+    chunk.versions[type] = tick;
+}
+
+/// EcsChunk_ChangedSince - true if any of the columns in mask were written after tick.
+inline bool
+EcsChunk_ChangedSince(EcsChunk const& chunk, EcsComponentMask const& mask, uint32 tick)
+{
+    for (auto type : mask)
+    {
+        if (chunk.versions[type] > tick)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+inline bool
+EcsArchetype_Has(EcsArchetype const& archetype, EcsComponentType type)
+{
+    return archetype.column_offsets[type] != ECS_NO_COLUMN;
+}
+
+/// EcsChunk_Entities - the handle of the entity in each row of the chunk.
+inline std::span<EcsEntity>
+EcsChunk_Entities(EcsChunk& chunk)
+{
+    return { Cast(EcsEntity*, Cast(void*, chunk.data)), chunk.count };
+}
+
+/// EcsChunk_ColumnData - the start of type's column in chunk, nullptr if the archetype doesn't have it.
+inline void*
+EcsChunk_ColumnData(EcsArchetype const& archetype, EcsChunk& chunk, EcsComponentType type)
+{
+    uint32 offset = archetype.column_offsets[type];
+    return offset == ECS_NO_COLUMN ? nullptr : chunk.data + offset;
+}
+
+/// EcsChunk_Column - the Tp of each row in chunk, empty if the archetype doesn't have Tp.
+/// NOTE: Doesn't mark the column as changed, writers call EcsChunk_MarkChanged.
+template <typename Tp>
+std::span<Tp>
+EcsChunk_Column(EcsArchetype const& archetype, EcsChunk& chunk)
+{
+    auto* data = Cast(Tp*, EcsChunk_ColumnData(archetype, chunk, Ecs_TypeId<Tp>()));
+    return { data, data ? chunk.count : 0 };
+}
+
+
+/// Ecs_Get - the entity's Tp, marked as changed unless Tp is const.
+template <typename Tp>
+Tp*
+Ecs_Get(EcsWorld& world, EcsEntity entity)
+{
+    if constexpr (std::is_const_v<Tp>)
+    {
+        return Cast(Tp*, Ecs_ReadComponent(world, entity, Ecs_TypeId<Tp>()));
+    }
+    else
+    {
+        return Cast(Tp*, Ecs_GetComponent(world, entity, Ecs_TypeId<Tp>()));
+    }
+}
+
+template <typename Tp>
+bool
+Ecs_Has(EcsWorld const& world, EcsEntity entity)
+{
+    return Ecs_ReadComponent(world, entity, Ecs_TypeId<Tp>()) != nullptr;
+}
+
+/// Ecs_Add - gives the entity a component of type Tp set to value and returns it.
+template <typename Tp>
+Tp*
+Ecs_Add(EcsWorld& world, EcsEntity entity, Tp value = Tp())
+{
+    auto* component = Cast(Tp*, Ecs_AddComponent(world, entity, Ecs_TypeId<Tp>()));
+    if (component)
+    {
+        *component = std::move(value);
+    }
+    return component;
+}
+
+template <typename Tp>
+bool
+Ecs_Remove(EcsWorld& world, EcsEntity entity)
+{
+    return Ecs_RemoveComponent(world, entity, Ecs_TypeId<Tp>());
+}
+
+
+/// Ecs_ForEachChunk - calls fn(archetype, chunk) for every non empty chunk
+/// whose archetype has all of the components in include.
+template <typename Fn>
+void
+Ecs_ForEachChunk(EcsWorld& world, EcsComponentMask const& include, Fn&& fn)
+{
+    for (auto& archetype : world.archetypes)
+    {
+        if (archetype->entity_count == 0 || !archetype->mask.contains(include))
+        {
+            continue;
+        }
+
+        for (auto& chunk : archetype->chunks)
+        {
+            fn(*archetype, chunk);
+        }
+    }
+}
+
+/// Ecs_Each - calls fn(Tps&...) for every entity that has all of Tps. The
+/// columns of the Tps that aren't const are marked as changed.
+template <typename... Tps, typename Fn>
+void
+Ecs_Each(EcsWorld& world, Fn&& fn)
+{
+    EcsComponentMask writes = Ecs_WriteMask<Tps...>();
+    uint32           tick   = Ecs_ChangeTick(world);
+
+    Ecs_ForEachChunk(world, Ecs_Mask<Tps...>(), [&](EcsArchetype& archetype, EcsChunk& chunk) {
+        for (auto type : writes)
+        {
+            EcsChunk_MarkChanged(chunk, Cast(EcsComponentType, type), tick);
+        }
+
+        auto columns = std::make_tuple(EcsChunk_Column<Tps>(archetype, chunk).data()...);
+        for (uint32 row = 0; row < chunk.count; ++row)
+        {
+            std::apply([&](auto*... column) { fn(column[row]...); }, columns);
+        }
+    });
+}
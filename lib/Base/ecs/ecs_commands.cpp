@@ -0,0 +1,305 @@
+#include "Base/ecs/ecs_commands.h"
+#include "Base/containers/small_vector.h"
+#include "Base/worker_pool.h"
+#include <algorithm>
+#include <cassert>
+#include <numeric>
+
+
+EcsCommandBuffer::~EcsCommandBuffer()
+{
+    EcsCommandBuffer_Clear(*this);
+    for (auto* page : pages)
+    {
+        ::operator delete(page, std::align_val_t(ECS_COLUMN_ALIGNMENT));
+    }
+}
+
+
+EcsEntity
+EcsCommandBuffer_Create(EcsCommandBuffer& buffer, EcsComponentMask const& mask)
+{
+    buffer.creates.push_back(mask);
+    return { Cast(uint32, buffer.creates.size() - 1), ECS_PENDING_GENERATION };
+}
+
+
+void
+EcsCommandBuffer_Destroy(EcsCommandBuffer& buffer, EcsEntity entity)
+{
+    buffer.commands.push_back({ entity, 0, EcsCommandType::Destroy, nullptr });
+}
+
+
+void
+EcsCommandBuffer_AddComponent(EcsCommandBuffer& buffer,
+                              EcsEntity         entity,
+                              EcsComponentType  type,
+                              void*             value)
+{
+    buffer.commands.push_back({ entity, type, EcsCommandType::Add, value });
+}
+
+
+void
+EcsCommandBuffer_RemoveComponent(EcsCommandBuffer& buffer, EcsEntity entity, EcsComponentType type)
+{
+    buffer.commands.push_back({ entity, type, EcsCommandType::Remove, nullptr });
+}
+
+
+void*
+EcsCommandBuffer_AllocateValue(EcsCommandBuffer& buffer, uint32 size, uint32 align)
+{
+    assert(size <= ECS_CHUNK_SIZE && align <= ECS_COLUMN_ALIGNMENT);
+
+    if (buffer.page_index < buffer.pages.size())
+    {
+        size_t offset = (buffer.page_used + (align - 1)) & ~size_t(align - 1);
+        if (offset + size <= ECS_CHUNK_SIZE)
+        {
+            buffer.page_used = offset + size;
+            return buffer.pages[buffer.page_index] + offset;
+        }
+        buffer.page_index += 1;
+    }
+
+    if (buffer.page_index == buffer.pages.size())
+    {
+        void* page = ::operator new(ECS_CHUNK_SIZE, std::align_val_t(ECS_COLUMN_ALIGNMENT));
+        buffer.pages.push_back(Cast(UByte*, page));
+    }
+    buffer.page_used = size;
+    return buffer.pages[buffer.page_index];
+}
+
+
+EcsEntity
+EcsCommandBuffer_Resolve(EcsCommandBuffer const& buffer, EcsEntity pending)
+{
+    if (!Ecs_IsPending(pending) || pending.index >= buffer.created.size())
+    {
+        return SLOT_HANDLE_INVALID;
+    }
+    return buffer.created[pending.index];
+}
+
+
+/// EcsCommandBuffer_Reset - forgets the commands, without destroying the values
+/// of added components, which have been applied or destroyed already.
+static void
+EcsCommandBuffer_Reset(EcsCommandBuffer& buffer)
+{
+    buffer.creates.clear();
+    buffer.commands.clear();
+    buffer.page_index = 0;
+    buffer.page_used  = 0;
+}
+
+
+void
+EcsCommandBuffer_Clear(EcsCommandBuffer& buffer)
+{
+    for (auto const& command : buffer.commands)
+    {
+        if (command.value)
+        {
+            Ecs_GetComponentInfo(command.component).destroy(command.value, 1);
+        }
+    }
+    EcsCommandBuffer_Reset(buffer);
+}
+
+
+//////////////////////////////////////////////////////////////////////////////
+
+
+void
+EcsCommands_Init(EcsCommands& commands, uint32 thread_count)
+{
+    assert(thread_count > 0);
+
+    commands.buffers.clear();
+    for (uint32 i = 0; i < thread_count; ++i)
+    {
+        commands.buffers.push_back(std::make_unique<EcsCommandBuffer>());
+    }
+}
+
+
+EcsCommandBuffer&
+EcsCommands_Local(EcsCommands& commands)
+{
+    uint32 thread_index = WorkerPool_ThreadIndex();
+    assert(thread_index < commands.buffers.size());
+    return *commands.buffers[thread_index];
+}
+
+
+/// Ecs_ApplyCreates - makes the buffer's pending entities, those with the same
+/// mask all at once.
+static void
+Ecs_ApplyCreates(EcsWorld& world, EcsCommandBuffer& buffer)
+{
+    size_t n = buffer.creates.size();
+    buffer.created.resize(n);
+    if (n == 0)
+    {
+        return;
+    }
+
+    std::vector<uint32> order(n);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](uint32 a, uint32 b) {
+        return buffer.creates[a].words[0] < buffer.creates[b].words[0];
+    });
+
+    std::vector<EcsEntity> entities;
+    for (size_t first = 0; first < n;)
+    {
+        EcsComponentMask const& mask = buffer.creates[order[first]];
+
+        size_t last = first + 1;
+        while (last < n && buffer.creates[order[last]] == mask)
+        {
+            last += 1;
+        }
+
+        entities.resize(last - first);
+        Ecs_CreateMany(world, mask, entities);
+        for (size_t i = first; i < last; ++i)
+        {
+            buffer.created[order[i]] = entities[i - first];
+        }
+        first = last;
+    }
+}
+
+
+using EcsValueList = SmallVector<std::pair<EcsComponentType, EcsCommand*>, 8>;
+
+static EcsCommand**
+Ecs_ValueSlot(EcsValueList& values, EcsComponentType type)
+{
+    for (auto& value : values)
+    {
+        if (value.first == type)
+        {
+            return &value.second;
+        }
+    }
+    values.push_back({ type, nullptr });
+    return &values.back().second;
+}
+
+
+/// Ecs_ApplyEntityCommands - applies the commands for one entity, which are all
+/// of commands, in the order they were recorded.
+static void
+Ecs_ApplyEntityCommands(EcsWorld& world, std::span<EcsCommand> commands)
+{
+    EcsEntity    entity   = commands[0].entity;
+    EcsLocation* location = world.entities.get(entity);
+    if (!location)
+    {
+        return;
+    }
+
+    bool destroy = std::any_of(commands.begin(), commands.end(), [](EcsCommand const& command) {
+        return command.type == EcsCommandType::Destroy;
+    });
+    if (destroy)
+    {
+        Ecs_Destroy(world, entity);
+        return;
+    }
+
+    // The command whose value each component ends up with, if any.
+    EcsValueList values;
+
+    EcsComponentMask mask = world.archetypes[location->archetype]->mask;
+    for (auto& command : commands)
+    {
+        if (command.type == EcsCommandType::Add)
+        {
+            // Like Ecs_Add, a value replaces the current one and no value keeps it.
+            if (command.value || !mask.test(command.component))
+            {
+                *Ecs_ValueSlot(values, command.component) = command.value ? &command : nullptr;
+            }
+            mask.set(command.component);
+        }
+        else
+        {
+            *Ecs_ValueSlot(values, command.component) = nullptr;
+            mask.reset(command.component);
+        }
+    }
+
+    Ecs_ChangeComponents(world, entity, mask);
+
+    for (auto& [type, command] : values)
+    {
+        if (command)
+        {
+            auto const& info = Ecs_GetComponentInfo(type);
+            void*       dst  = Ecs_GetComponent(world, entity, type);
+            info.destroy(dst, 1);
+            info.relocate(dst, command->value, 1);
+            command->value = nullptr;
+        }
+    }
+}
+
+
+void
+Ecs_ApplyCommands(EcsWorld& world, EcsCommands& commands)
+{
+    auto& batch = commands.batch;
+    batch.clear();
+
+    for (auto& buffer : commands.buffers)
+    {
+        Ecs_ApplyCreates(world, *buffer);
+
+        for (auto command : buffer->commands)
+        {
+            if (Ecs_IsPending(command.entity))
+            {
+                command.entity = EcsCommandBuffer_Resolve(*buffer, command.entity);
+            }
+            batch.push_back(command);
+        }
+    }
+
+    std::stable_sort(batch.begin(), batch.end(), [](EcsCommand const& a, EcsCommand const& b) {
+        return a.entity.index != b.entity.index ? a.entity.index < b.entity.index
+                                                : a.entity.generation < b.entity.generation;
+    });
+
+    for (size_t first = 0; first < batch.size();)
+    {
+        size_t last = first + 1;
+        while (last < batch.size() && batch[last].entity == batch[first].entity)
+        {
+            last += 1;
+        }
+        Ecs_ApplyEntityCommands(world, std::span<EcsCommand>(batch.data() + first, last - first));
+        first = last;
+    }
+
+    // Values that were replaced, removed again or meant for a dead entity.
+    for (auto const& command : batch)
+    {
+        if (command.value)
+        {
+            Ecs_GetComponentInfo(command.component).destroy(command.value, 1);
+        }
+    }
+    batch.clear();
+
+    for (auto& buffer : commands.buffers)
+    {
+        EcsCommandBuffer_Reset(*buffer);
+    }
+}
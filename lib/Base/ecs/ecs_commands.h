@@ -0,0 +1,151 @@
+#pragma once
+
+#include "Base/dllexports.h"
+#include "Base/ecs/ecs.h"
+#include "Base/typedefs.h"
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+
+//////////////////////////////////////////////////////////////////////////////
+//
+// Deferred structural changes.
+//
+// Creating and destroying entities, and adding and removing components, move
+// rows between chunks, so they can't happen while systems iterate or run in
+// parallel. Systems record them in their thread's command buffer instead and
+// Ecs_ApplyCommands makes them all at a sync point, once every system is done.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+
+// Marks a handle from EcsCommandBuffer_Create, which only means something to
+// the buffer that made it until the commands are applied.
+constexpr uint32 ECS_PENDING_GENERATION = UINT32_MAX - 1;
+
+
+enum class EcsCommandType : uint8
+{
+    Destroy,
+    Add,
+    Remove,
+};
+
+
+struct EcsCommand
+{
+    EcsEntity        entity;
+    EcsComponentType component;
+    EcsCommandType   type;
+
+    // The value to give an added component, nullptr to value initialise it.
+    // Lives in the buffer's pages until it is applied or the buffer is cleared.
+    void* value;
+};
+
+
+public_struct EcsCommandBuffer
+{
+    std::vector<EcsComponentMask> creates;  // The mask of each pending entity.
+    std::vector<EcsEntity>        created;  // What each pending entity became, once applied.
+    std::vector<EcsCommand>       commands;
+
+    // Pages of ECS_CHUNK_SIZE holding the values of added components, kept for reuse.
+    std::vector<UByte*> pages;
+    size_t              page_index { 0 };
+    size_t              page_used { 0 };
+
+    EcsCommandBuffer()                        = default;
+    EcsCommandBuffer(EcsCommandBuffer const&) = delete;
+    EcsCommandBuffer&
+    operator=(EcsCommandBuffer const&) = delete;
+    ~EcsCommandBuffer();
+};
+
+
+/// EcsCommands - one command buffer per thread that runs systems.
+public_struct EcsCommands
+{
+    std::vector<std::unique_ptr<EcsCommandBuffer>> buffers;
+
+    // Every buffer's commands, sorted by entity when applying.
+    std::vector<EcsCommand> batch;
+};
+
+
+inline bool
+Ecs_IsPending(EcsEntity entity)
+{
+    return entity.generation == ECS_PENDING_GENERATION;
+}
+
+
+/// EcsCommandBuffer_Create - records creating an entity with the components in mask.
+/// Returns a pending handle that can be given to later commands in the same buffer.
+public_func EcsEntity
+EcsCommandBuffer_Create(EcsCommandBuffer& buffer, EcsComponentMask const& mask);
+
+public_func void
+EcsCommandBuffer_Destroy(EcsCommandBuffer& buffer, EcsEntity entity);
+
+/// EcsCommandBuffer_AddComponent - records adding a component of type. value, if not
+/// nullptr, must come from EcsCommandBuffer_AllocateValue and hold a constructed component.
+public_func void
+EcsCommandBuffer_AddComponent(EcsCommandBuffer& buffer,
+                              EcsEntity         entity,
+                              EcsComponentType  type,
+                              void*             value = nullptr);
+
+public_func void
+EcsCommandBuffer_RemoveComponent(EcsCommandBuffer& buffer, EcsEntity entity, EcsComponentType type);
+
+/// EcsCommandBuffer_AllocateValue - room in the buffer for the value of an added component.
+public_func void*
+EcsCommandBuffer_AllocateValue(EcsCommandBuffer& buffer, uint32 size, uint32 align);
+
+/// EcsCommandBuffer_Resolve - the entity a pending handle became, after the commands were applied.
+public_func EcsEntity
+EcsCommandBuffer_Resolve(EcsCommandBuffer const& buffer, EcsEntity pending);
+
+/// EcsCommandBuffer_Clear - drops every command that hasn't been applied.
+public_func void
+EcsCommandBuffer_Clear(EcsCommandBuffer& buffer);
+
+
+/// EcsCommands_Init - one buffer for each of thread_count threads, see WorkerPool_ThreadCount.
+public_func void
+EcsCommands_Init(EcsCommands& commands, uint32 thread_count);
+
+/// EcsCommands_Local - the calling thread's buffer.
+public_func EcsCommandBuffer&
+EcsCommands_Local(EcsCommands& commands);
+
+/// Ecs_ApplyCommands - makes every recorded change, then clears the buffers. The
+/// pending handles of each buffer can be resolved until the next apply.
+///
+/// Creates are grouped by mask and made with Ecs_CreateMany. The other commands
+/// are sorted by entity, so each entity moves archetype at most once however
+/// many components it gains or loses. Commands for the same entity are applied
+/// in the order they were recorded within a buffer, and in buffer order across
+/// buffers. Destroying an entity drops the other commands for it.
+public_func void
+Ecs_ApplyCommands(EcsWorld& world, EcsCommands& commands);
+
+
+template <typename Tp>
+void
+EcsCommandBuffer_Add(EcsCommandBuffer& buffer, EcsEntity entity, Tp value = Tp())
+{
+    void* storage = EcsCommandBuffer_AllocateValue(buffer, sizeof(Tp), alignof(Tp));
+    ::new (storage) Tp(std::move(value));
+    EcsCommandBuffer_AddComponent(buffer, entity, Ecs_TypeId<Tp>(), storage);
+}
+
+template <typename Tp>
+void
+EcsCommandBuffer_Remove(EcsCommandBuffer& buffer, EcsEntity entity)
+{
+    EcsCommandBuffer_RemoveComponent(buffer, entity, Ecs_TypeId<Tp>());
+}
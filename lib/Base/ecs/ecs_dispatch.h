@@ -0,0 +1,107 @@
+#pragma once
+
+#include "Base/dllexports.h"
+#include "Base/ecs/ecs.h"
+#include "Base/typedefs.h"
+#include <cstddef>
+#include <span>
+#include <vector>
+
+
+/// EcsDispatch - groups entities by the handler they need, then calls each
+/// handler once with all of its entities.
+///
+/// Calling a function pointer per entity mispredicts whenever neighbouring
+/// entities want different handlers, and each handler only ever sees a single
+/// entity. Collecting the entities first costs one indirect call per handler
+/// per pass and hands the handler a span it can loop over however it likes.
+/// Handlers are looked up linearly, starting from the last one used, which
+/// suits a handful of handlers shared by many entities, e.g.
+///
+///     dispatch.clear();
+///     view.each_chunk(world, [&](EcsChunk& chunk, std::span<State const> states) { ... add ... });
+///     dispatch.run([&](Handler handler, std::span<EcsEntity const> entities) {
+///         handler(world, entities);
+///     });
+///
+/// Buckets, and their storage, are kept between passes.
+template <typename Handler>
+struct EcsDispatch
+{
+    struct Bucket
+    {
+        Handler                handler;
+        std::vector<EcsEntity> entities;
+    };
+
+    // Data members
+    //
+    std::vector<Bucket> buckets;
+    size_t              last_bucket { 0 };
+
+
+    /// clear - empties every bucket, keeping their storage for the next pass.
+    void
+    clear() noexcept
+    {
+        for (auto& bucket : buckets)
+        {
+            bucket.entities.clear();
+        }
+    }
+
+    /// add - puts entity in handler's bucket, making the bucket the first time handler is seen.
+    void
+    add(Handler const& handler, EcsEntity entity)
+    {
+        if (last_bucket >= buckets.size() || !(buckets[last_bucket].handler == handler))
+        {
+            last_bucket = find_or_add(handler);
+        }
+        buckets[last_bucket].entities.push_back(entity);
+    }
+
+    /// run - calls fn(handler, std::span<EcsEntity const>) for every handler that has entities,
+    /// in the order the handlers were first seen.
+    template <typename Fn>
+    void
+    run(Fn&& fn)
+    {
+        for (auto& bucket : buckets)
+        {
+            if (!bucket.entities.empty())
+            {
+                fn(bucket.handler, std::span<EcsEntity const>(bucket.entities));
+            }
+        }
+    }
+
+    /// size - the number of entities added since the last clear.
+    size_t
+    size() const noexcept
+    {
+        size_t n = 0;
+        for (auto const& bucket : buckets)
+        {
+            n += bucket.entities.size();
+        }
+        return n;
+    }
+
+
+    // Implementation.
+    //
+    size_t
+    find_or_add(Handler const& handler)
+    {
+        for (size_t i = 0; i < buckets.size(); ++i)
+        {
+            if (buckets[i].handler == handler)
+            {
+                return i;
+            }
+        }
+        buckets.push_back({ handler, {} });
+        return buckets.size() - 1;
+    }
+};
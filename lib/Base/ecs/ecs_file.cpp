@@ -0,0 +1,527 @@
+#include "Base/ecs/ecs_file.h"
+#include <algorithm>
+#include <cassert>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+
+
+using EcsSlot = SlotMap<EcsLocation>::Slot;
+
+static_assert(std::is_trivially_copyable_v<EcsLocation>);
+static_assert(std::is_trivially_copyable_v<EcsSlot>);
+static_assert(std::is_trivially_copyable_v<EcsEntity>);
+
+
+static inline uint64
+AlignUp(uint64 value, uint64 align)
+{
+    return (value + (align - 1)) & ~(align - 1);
+}
+
+
+/// EcsFile_InRange - true if count elements starting at offset fit in an image of size bytes.
+static inline bool
+EcsFile_InRange(uint64 size, uint64 offset, uint64 count, uint64 element_size)
+{
+    return offset <= size && count <= (size - offset) / element_size;
+}
+
+
+/// EcsFile_ForEachColumn - calls fn(column, offset) for each column of a chunk
+/// with count rows stored at offset, after its entities. Returns where the
+/// chunk ends.
+template <typename Fn>
+static uint64
+EcsFile_ForEachColumn(std::span<uint32 const> sizes, uint32 count, uint64 offset, Fn&& fn)
+{
+    offset += uint64(count) * sizeof(EcsEntity);
+    for (uint32 column = 0; column < sizes.size(); ++column)
+    {
+        offset = AlignUp(offset, ECS_COLUMN_ALIGNMENT);
+        fn(column, offset);
+        offset += uint64(count) * sizes[column];
+    }
+    return offset;
+}
+
+
+/// EcsFile_FindComponent - the registered type with name and size, ECS_MAX_COMPONENTS if none.
+static uint32
+EcsFile_FindComponent(char const* name, uint32 name_length, uint32 size)
+{
+    for (uint32 type = 0; type < Ecs_ComponentTypeCount(); ++type)
+    {
+        auto const& info = Ecs_GetComponentInfo(Cast(EcsComponentType, type));
+        if (info.size == size && std::strlen(info.name) == name_length
+            && std::memcmp(info.name, name, name_length) == 0)
+        {
+            return type;
+        }
+    }
+    return ECS_MAX_COMPONENTS;
+}
+
+
+//////////////////////////////////////////////////////////////////////////////
+
+
+EcsFileError
+Ecs_SaveWorld(EcsWorld const& world, std::vector<UByte>& image)
+{
+    // The components of every archetype, numbered in the order they are first seen.
+    std::array<uint32, ECS_MAX_COMPONENTS> file_index;
+    file_index.fill(UINT32_MAX);
+    std::vector<EcsComponentType> components;
+
+    EcsFileHeader header {};
+    header.magic   = ECS_FILE_MAGIC;
+    header.version = ECS_FILE_VERSION;
+
+    for (auto const& archetype : world.archetypes)
+    {
+        for (auto type : archetype->types)
+        {
+            auto const& info = Ecs_GetComponentInfo(type);
+            if (archetype->entity_count > 0 && !info.trivially_copyable)
+            {
+                return EcsFileError::NOT_TRIVIALLY_COPYABLE;
+            }
+            if (file_index[type] == UINT32_MAX)
+            {
+                file_index[type] = Cast(uint32, components.size());
+                components.push_back(type);
+            }
+        }
+        header.column_count += Cast(uint32, archetype->types.size());
+        header.chunk_count += Cast(uint32, archetype->chunks.size());
+    }
+    header.component_count = Cast(uint32, components.size());
+    header.archetype_count = Cast(uint32, world.archetypes.size());
+    header.entity_count    = Cast(uint32, world.entities.dense.size());
+    header.slot_count      = Cast(uint32, world.entities.slots.size());
+    header.free_head       = world.entities.free_head;
+
+    // Lay out the tables, then the names, then the chunks.
+    uint64 size = sizeof(EcsFileHeader);
+    auto   put  = [&](uint64& offset, uint64 count, uint64 element_size) {
+        offset = AlignUp(size, 8);
+        size   = offset + (count * element_size);
+    };
+    put(header.components, header.component_count, sizeof(EcsFileComponent));
+    put(header.archetypes, header.archetype_count, sizeof(EcsFileArchetype));
+    put(header.columns, header.column_count, sizeof(uint32));
+    put(header.chunks, header.chunk_count, sizeof(EcsFileChunk));
+    put(header.locations, header.entity_count, sizeof(EcsLocation));
+    put(header.dense_to_slot, header.entity_count, sizeof(uint32));
+    put(header.slots, header.slot_count, sizeof(EcsSlot));
+
+    std::vector<EcsFileComponent> file_components;
+    for (auto type : components)
+    {
+        auto const& info   = Ecs_GetComponentInfo(type);
+        uint32      length = Cast(uint32, std::strlen(info.name));
+        file_components.push_back({ size, length, info.size });
+        size += length;
+    }
+
+    std::vector<EcsFileArchetype> file_archetypes;
+    std::vector<uint32>           file_columns;
+    std::vector<EcsFileChunk>     file_chunks;
+    std::vector<uint32>           sizes;
+    for (auto const& archetype : world.archetypes)
+    {
+        file_archetypes.push_back({ Cast(uint32, file_columns.size()),
+                                    Cast(uint32, archetype->types.size()) });
+        sizes.clear();
+        for (auto type : archetype->types)
+        {
+            file_columns.push_back(file_index[type]);
+            sizes.push_back(Ecs_GetComponentInfo(type).size);
+        }
+
+        for (auto const& chunk : archetype->chunks)
+        {
+            uint64 offset = AlignUp(size, ECS_COLUMN_ALIGNMENT);
+            file_chunks.push_back({ offset, archetype->index, chunk.count });
+            size = EcsFile_ForEachColumn(sizes, chunk.count, offset, [](auto...) {});
+        }
+    }
+    header.size = size;
+
+    image.resize(size);
+    UByte* dst = image.data();
+
+    std::memcpy(dst, &header, sizeof(header));
+    std::memcpy(dst + header.components,
+                file_components.data(),
+                file_components.size() * sizeof(EcsFileComponent));
+    std::memcpy(dst + header.archetypes,
+                file_archetypes.data(),
+                file_archetypes.size() * sizeof(EcsFileArchetype));
+    std::memcpy(dst + header.columns, file_columns.data(), file_columns.size() * sizeof(uint32));
+    std::memcpy(dst + header.chunks, file_chunks.data(), file_chunks.size() * sizeof(EcsFileChunk));
+    std::memcpy(dst + header.locations,
+                world.entities.dense.data(),
+                world.entities.dense.size() * sizeof(EcsLocation));
+    std::memcpy(dst + header.dense_to_slot,
+                world.entities.dense_to_slot.data(),
+                world.entities.dense_to_slot.size() * sizeof(uint32));
+    std::memcpy(dst + header.slots,
+                world.entities.slots.data(),
+                world.entities.slots.size() * sizeof(EcsSlot));
+
+    for (size_t i = 0; i < components.size(); ++i)
+    {
+        std::memcpy(dst + file_components[i].name,
+                    Ecs_GetComponentInfo(components[i]).name,
+                    file_components[i].name_length);
+    }
+
+    size_t chunk_idx = 0;
+    for (auto const& archetype : world.archetypes)
+    {
+        sizes.clear();
+        for (auto type : archetype->types)
+        {
+            sizes.push_back(Ecs_GetComponentInfo(type).size);
+        }
+
+        for (auto const& chunk : archetype->chunks)
+        {
+            uint64 offset = file_chunks[chunk_idx++].offset;
+            auto   save   = [&](uint32 column, uint64 column_offset) {
+                UByte const* src = chunk.data + archetype->column_offsets[archetype->types[column]];
+                std::memcpy(dst + column_offset, src, uint64(chunk.count) * sizes[column]);
+            };
+            std::memcpy(dst + offset, chunk.data, chunk.count * sizeof(EcsEntity));
+            EcsFile_ForEachColumn(sizes, chunk.count, offset, save);
+        }
+    }
+
+    return EcsFileError::NO_ERROR;
+}
+
+
+EcsFileError
+Ecs_LoadWorld(EcsWorld& world, std::span<UByte const> image)
+{
+    UByte const* src = image.data();
+
+    EcsFileHeader header;
+    if (image.size() < sizeof(header))
+    {
+        return EcsFileError::BAD_HEADER;
+    }
+    std::memcpy(&header, src, sizeof(header));
+    if (header.magic != ECS_FILE_MAGIC || header.version != ECS_FILE_VERSION
+        || header.size != image.size())
+    {
+        return EcsFileError::BAD_HEADER;
+    }
+
+    uint64 size            = header.size;
+    uint64 component_count = header.component_count;
+    uint64 archetype_count = header.archetype_count;
+    if (!EcsFile_InRange(size, header.components, component_count, sizeof(EcsFileComponent))
+        || !EcsFile_InRange(size, header.archetypes, archetype_count, sizeof(EcsFileArchetype))
+        || !EcsFile_InRange(size, header.columns, header.column_count, sizeof(uint32))
+        || !EcsFile_InRange(size, header.chunks, header.chunk_count, sizeof(EcsFileChunk))
+        || !EcsFile_InRange(size, header.locations, header.entity_count, sizeof(EcsLocation))
+        || !EcsFile_InRange(size, header.dense_to_slot, header.entity_count, sizeof(uint32))
+        || !EcsFile_InRange(size, header.slots, header.slot_count, sizeof(EcsSlot)))
+    {
+        return EcsFileError::CORRUPT;
+    }
+
+    // Match the image's components to the registered ones.
+    std::vector<EcsComponentType> types(header.component_count);
+    std::vector<uint32>           sizes(header.component_count);
+    for (uint32 i = 0; i < header.component_count; ++i)
+    {
+        EcsFileComponent component;
+        UByte const*     at = src + header.components + (i * sizeof(component));
+        std::memcpy(&component, at, sizeof(component));
+        if (!EcsFile_InRange(size, component.name, component.name_length, 1))
+        {
+            return EcsFileError::CORRUPT;
+        }
+
+        char const* name = Cast(char const*, Cast(void const*, src + component.name));
+        uint32      type = EcsFile_FindComponent(name, component.name_length, component.size);
+        if (type == ECS_MAX_COMPONENTS)
+        {
+            return EcsFileError::UNKNOWN_COMPONENT;
+        }
+        if (!Ecs_GetComponentInfo(Cast(EcsComponentType, type)).trivially_copyable)
+        {
+            return EcsFileError::NOT_TRIVIALLY_COPYABLE;
+        }
+        types[i] = Cast(EcsComponentType, type);
+        sizes[i] = component.size;
+    }
+
+    std::vector<uint32> columns(header.column_count);
+    std::memcpy(columns.data(), src + header.columns, columns.size() * sizeof(uint32));
+
+    // The mask of each of the image's archetypes, and the type and size of
+    // its columns. The types needn't be in the world's order, the type ids
+    // can differ from the ones the image was saved with.
+    //
+    // NOTE: The world's archetypes are only looked up, and so created, once
+    // the whole image has been checked.
+    std::vector<EcsComponentMask>              masks(header.archetype_count);
+    std::vector<uint32>                        capacities(header.archetype_count);
+    std::vector<EcsFileArchetype>              file_archetypes(header.archetype_count);
+    std::vector<std::vector<EcsComponentType>> column_types(header.archetype_count);
+    std::vector<std::vector<uint32>>           column_sizes(header.archetype_count);
+    std::memcpy(file_archetypes.data(),
+                src + header.archetypes,
+                file_archetypes.size() * sizeof(EcsFileArchetype));
+    for (uint32 i = 0; i < header.archetype_count; ++i)
+    {
+        auto const& file_archetype = file_archetypes[i];
+        if (file_archetype.first_column > header.column_count
+            || file_archetype.column_count > header.column_count - file_archetype.first_column)
+        {
+            return EcsFileError::CORRUPT;
+        }
+
+        EcsComponentMask mask;
+        for (uint32 c = 0; c < file_archetype.column_count; ++c)
+        {
+            uint32 component = columns[file_archetype.first_column + c];
+            if (component >= header.component_count || mask.test(types[component]))
+            {
+                return EcsFileError::CORRUPT;
+            }
+            mask.set(types[component]);
+            column_types[i].push_back(types[component]);
+            column_sizes[i].push_back(sizes[component]);
+        }
+        masks[i]      = mask;
+        capacities[i] = Ecs_ChunkCapacity(mask);
+    }
+
+    // Two archetypes with the same mask would load into one of the world's.
+    std::vector<uint64> sorted_masks(header.archetype_count);
+    for (uint32 i = 0; i < header.archetype_count; ++i)
+    {
+        sorted_masks[i] = masks[i].words[0];
+    }
+    std::sort(sorted_masks.begin(), sorted_masks.end());
+    if (std::adjacent_find(sorted_masks.begin(), sorted_masks.end()) != sorted_masks.end())
+    {
+        return EcsFileError::CORRUPT;
+    }
+
+    // NOTE: Chunks are stored by archetype, in the order the locations number them.
+    std::vector<EcsFileChunk> chunks(header.chunk_count);
+    std::vector<uint32>       first_chunk(header.archetype_count + 1, 0);
+    std::memcpy(chunks.data(), src + header.chunks, chunks.size() * sizeof(EcsFileChunk));
+
+    uint64 row_count = 0;
+    for (uint32 i = 0; i < header.chunk_count; ++i)
+    {
+        auto const& chunk = chunks[i];
+        if (chunk.archetype >= header.archetype_count
+            || (i > 0 && chunk.archetype < chunks[i - 1].archetype)
+            || chunk.count == 0 || chunk.count > capacities[chunk.archetype]
+            || chunk.offset % ECS_COLUMN_ALIGNMENT != 0)
+        {
+            return EcsFileError::CORRUPT;
+        }
+
+        uint64 end = EcsFile_ForEachColumn(column_sizes[chunk.archetype],
+                                           chunk.count,
+                                           chunk.offset,
+                                           [](auto...) {});
+        if (chunk.offset > size || end > size)
+        {
+            return EcsFileError::CORRUPT;
+        }
+        first_chunk[chunk.archetype + 1] += 1;
+        row_count += chunk.count;
+    }
+    for (uint32 i = 0; i < header.archetype_count; ++i)
+    {
+        first_chunk[i + 1] += first_chunk[i];
+    }
+
+    // Check the entity index against the entities stored with each chunk, so
+    // every handle resolves to the row holding it.
+    std::vector<EcsLocation> locations(header.entity_count);
+    std::vector<uint32>      dense_to_slot(header.entity_count);
+    std::vector<EcsSlot>     slots(header.slot_count);
+    std::memcpy(locations.data(), src + header.locations, locations.size() * sizeof(EcsLocation));
+    std::memcpy(dense_to_slot.data(),
+                src + header.dense_to_slot,
+                dense_to_slot.size() * sizeof(uint32));
+    std::memcpy(slots.data(), src + header.slots, slots.size() * sizeof(EcsSlot));
+
+    if (row_count != header.entity_count || header.entity_count > header.slot_count)
+    {
+        return EcsFileError::CORRUPT;
+    }
+
+    // NOTE: Each row must be looked at once to know the index is sound, so this
+    // walks each chunk's entity column, a block at a time. A row's location
+    // has to name that row, so no two locations can share one, and as there
+    // are as many rows as locations, every location is reached.
+    std::vector<EcsEntity> entities;
+    for (uint32 i = 0; i < header.chunk_count; ++i)
+    {
+        auto const& chunk = chunks[i];
+        entities.resize(chunk.count);
+        std::memcpy(entities.data(), src + chunk.offset, chunk.count * sizeof(EcsEntity));
+
+        uint32 chunk_index = i - first_chunk[chunk.archetype];
+        for (uint32 row = 0; row < chunk.count; ++row)
+        {
+            EcsEntity entity = entities[row];
+            if (entity.index >= header.slot_count)
+            {
+                return EcsFileError::CORRUPT;
+            }
+
+            EcsSlot const& slot  = slots[entity.index];
+            uint32         dense = slot.dense_or_next_free;
+            if (slot.generation != entity.generation || dense >= header.entity_count
+                || dense_to_slot[dense] != entity.index)
+            {
+                return EcsFileError::CORRUPT;
+            }
+
+            auto const& location = locations[dense];
+            if (location.archetype != chunk.archetype || location.chunk != chunk_index
+                || location.row != row)
+            {
+                return EcsFileError::CORRUPT;
+            }
+        }
+    }
+
+    // Every other slot must be on the free list, which mustn't name a live one.
+    uint32 free_count = 0;
+    for (uint32 slot = header.free_head; slot != SlotMap<EcsLocation>::FREE_LIST_END;
+         slot        = slots[slot].dense_or_next_free)
+    {
+        if (slot >= header.slot_count || ++free_count > header.slot_count - header.entity_count)
+        {
+            return EcsFileError::CORRUPT;
+        }
+
+        uint32 dense = slots[slot].dense_or_next_free;
+        if (dense < header.entity_count && dense_to_slot[dense] == slot)
+        {
+            return EcsFileError::CORRUPT;
+        }
+    }
+    if (free_count != header.slot_count - header.entity_count)
+    {
+        return EcsFileError::CORRUPT;
+    }
+
+    // The image is sound, so nothing can fail from here on.
+    std::vector<EcsArchetype*> archetypes(header.archetype_count);
+    bool                       remap = false;
+    for (uint32 i = 0; i < header.archetype_count; ++i)
+    {
+        archetypes[i] = Ecs_GetArchetype(world, masks[i]);
+        remap |= archetypes[i]->index != i;
+    }
+    Ecs_Clear(world);
+
+    uint32 tick = Ecs_ChangeTick(world);
+    for (auto const& saved : chunks)
+    {
+        EcsArchetype& archetype = *archetypes[saved.archetype];
+        auto const&   types_of  = column_types[saved.archetype];
+        auto const&   sizes_of  = column_sizes[saved.archetype];
+        EcsChunk      chunk { Ecs_AllocateChunk(world), saved.count };
+
+        auto load = [&](uint32 column, uint64 offset) {
+            EcsComponentType type = types_of[column];
+            std::memcpy(chunk.data + archetype.column_offsets[type],
+                        src + offset,
+                        uint64(saved.count) * sizes_of[column]);
+            EcsChunk_MarkChanged(chunk, type, tick);
+        };
+        std::memcpy(chunk.data, src + saved.offset, saved.count * sizeof(EcsEntity));
+        EcsFile_ForEachColumn(sizes_of, saved.count, saved.offset, load);
+
+        archetype.chunks.push_back(chunk);
+        archetype.entity_count += saved.count;
+    }
+
+    if (remap)
+    {
+        for (auto& location : locations)
+        {
+            location.archetype = archetypes[location.archetype]->index;
+        }
+    }
+    world.entities.dense         = std::move(locations);
+    world.entities.dense_to_slot = std::move(dense_to_slot);
+    world.entities.slots         = std::move(slots);
+    world.entities.free_head     = header.free_head;
+
+    return EcsFileError::NO_ERROR;
+}
+
+
+//////////////////////////////////////////////////////////////////////////////
+
+
+EcsFileError
+Ecs_SaveWorldFile(EcsWorld const& world, char const* path)
+{
+    std::vector<UByte> image;
+    EcsFileError       error = Ecs_SaveWorld(world, image);
+    if (error != EcsFileError::NO_ERROR)
+    {
+        return error;
+    }
+
+    FILE* file = fopen(path, "wb");
+    if (!file)
+    {
+        return EcsFileError::OPEN_ERROR;
+    }
+    size_t written = fwrite(image.data(), 1, image.size(), file);
+    bool   closed  = fclose(file) == 0;
+    return written == image.size() && closed ? EcsFileError::NO_ERROR : EcsFileError::WRITE_ERROR;
+}
+
+
+EcsFileError
+Ecs_LoadWorldFile(EcsWorld& world, char const* path)
+{
+    FILE* file = fopen(path, "rb");
+    if (!file)
+    {
+        return EcsFileError::OPEN_ERROR;
+    }
+
+    long size = -1;
+    if (fseek(file, 0, SEEK_END) == 0)
+    {
+        size = ftell(file);
+    }
+    if (size < 0 || fseek(file, 0, SEEK_SET) != 0)
+    {
+        fclose(file);
+        return EcsFileError::READ_ERROR;
+    }
+
+    // NOTE: Not a vector, which would zero the whole image before reading over it.
+    std::unique_ptr<UByte[]> image(new UByte[size]);
+    size_t                   read = fread(image.get(), 1, size, file);
+    fclose(file);
+    if (read != Cast(size_t, size))
+    {
+        return EcsFileError::READ_ERROR;
+    }
+
+    return Ecs_LoadWorld(world, { image.get(), Cast(size_t, size) });
+}
@@ -0,0 +1,113 @@
+#pragma once
+
+#include "Base/dllexports.h"
+#include "Base/ecs/ecs.h"
+#include "Base/typedefs.h"
+#include <span>
+#include <vector>
+
+
+//////////////////////////////////////////////////////////////////////////////
+//
+// Saving a world to, and loading it from, a binary image.
+//
+// The image holds the used rows of every chunk, a column at a time, and the
+// entity index, each as one contiguous block found through an offset from
+// the start of the image. Saving and loading copy whole columns and whole
+// arrays, there is no per component or per field code.
+//
+// Component types are matched by name and size rather than by type id, since
+// the ids depend on the order types were first used in. Only trivially
+// copyable components can be saved, and any pointers they hold, such as an
+// SDL_Texture*, mean nothing once loaded; keep an index into a table instead.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+
+constexpr uint32 ECS_FILE_MAGIC   = 0x57534345; // "ECSW"
+constexpr uint32 ECS_FILE_VERSION = 1;
+
+
+enum class EcsFileError
+{
+    NO_ERROR               = 0,
+    OPEN_ERROR             = 1,
+    READ_ERROR             = 2,
+    WRITE_ERROR            = 3,
+    NOT_TRIVIALLY_COPYABLE = 4, // A component can't be saved as raw bytes.
+    BAD_HEADER             = 5, // Not an image, or one from another version.
+    UNKNOWN_COMPONENT      = 6, // A component in the image isn't registered, or changed size.
+    CORRUPT                = 7, // An offset or count points outside the image.
+};
+
+
+// NOTE: Every offset is in bytes from the start of the image.
+struct EcsFileHeader
+{
+    uint32 magic;
+    uint32 version;
+    uint64 size;
+
+    uint32 component_count; // EcsFileComponent
+    uint32 archetype_count; // EcsFileArchetype
+    uint32 column_count;    // uint32, the component of each column of each archetype.
+    uint32 chunk_count;     // EcsFileChunk
+    uint64 components;
+    uint64 archetypes;
+    uint64 columns;
+    uint64 chunks;
+
+    // The entity index, see SlotMap.
+    uint32 entity_count;
+    uint32 slot_count;
+    uint32 free_head;
+    uint32 padding;
+    uint64 locations;
+    uint64 dense_to_slot;
+    uint64 slots;
+};
+
+
+struct EcsFileComponent
+{
+    uint64 name;
+    uint32 name_length;
+    uint32 size;
+};
+
+
+struct EcsFileArchetype
+{
+    uint32 first_column;
+    uint32 column_count;
+};
+
+
+/// EcsFileChunk - a chunk's entities, then each of its columns on a cache line.
+struct EcsFileChunk
+{
+    uint64 offset;
+    uint32 archetype;
+    uint32 count;
+};
+
+
+/// Ecs_SaveWorld - writes the world into image, replacing what it held.
+public_func EcsFileError
+Ecs_SaveWorld(EcsWorld const& world, std::vector<UByte>& image);
+
+/// Ecs_LoadWorld - replaces every entity in the world with those in image.
+///
+/// The image is checked before the world is touched, so on an error the
+/// world is left as it was. Handles saved with the image resolve to the same
+/// entities once it is loaded.
+public_func EcsFileError
+Ecs_LoadWorld(EcsWorld& world, std::span<UByte const> image);
+
+/// Ecs_SaveWorldFile - Ecs_SaveWorld, then writes the image to path in one go.
+public_func EcsFileError
+Ecs_SaveWorldFile(EcsWorld const& world, char const* path);
+
+/// Ecs_LoadWorldFile - reads the whole file at path in one go, then Ecs_LoadWorld.
+public_func EcsFileError
+Ecs_LoadWorldFile(EcsWorld& world, char const* path);
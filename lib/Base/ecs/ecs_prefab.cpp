@@ -0,0 +1,53 @@
+#include "Base/ecs/ecs_prefab.h"
+#include <new>
+
+
+EcsPrefab::~EcsPrefab()
+{
+    EcsPrefab_Clear(*this);
+}
+
+
+void*
+EcsPrefab_SetComponent(EcsPrefab& prefab, EcsComponentType type)
+{
+    prefab.mask.set(type);
+    if (!prefab.values[type])
+    {
+        auto const& info    = Ecs_GetComponentInfo(type);
+        prefab.values[type] = ::operator new(info.size, std::align_val_t(info.align));
+        info.construct(prefab.values[type], 1);
+    }
+    return prefab.values[type];
+}
+
+
+void
+EcsPrefab_AddComponent(EcsPrefab& prefab, EcsComponentType type)
+{
+    prefab.mask.set(type);
+}
+
+
+void
+EcsPrefab_Clear(EcsPrefab& prefab)
+{
+    for (auto type : prefab.mask)
+    {
+        if (void* value = prefab.values[type])
+        {
+            auto const& info = Ecs_GetComponentInfo(Cast(EcsComponentType, type));
+            info.destroy(value, 1);
+            ::operator delete(value, std::align_val_t(info.align));
+            prefab.values[type] = nullptr;
+        }
+    }
+    prefab.mask.clear();
+}
+
+
+void
+EcsPrefab_Instantiate(EcsWorld& world, EcsPrefab const& prefab, std::span<EcsEntity> out)
+{
+    Ecs_CreateManyFrom(world, prefab.mask, prefab.values.data(), out);
+}
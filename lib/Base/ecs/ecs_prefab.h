@@ -0,0 +1,75 @@
+#pragma once
+
+#include "Base/dllexports.h"
+#include "Base/ecs/ecs.h"
+#include "Base/typedefs.h"
+#include <array>
+#include <span>
+#include <utility>
+
+
+/// EcsPrefab - a set of components with the values new entities start with.
+///
+/// Instantiating creates every entity in one go, a chunk at a time, and copies
+/// each component's value down its column, rather than creating an entity and
+/// then looking up and setting each of its components in turn. Anything that
+/// differs between the instances, such as where they spawn, is set afterwards
+/// through the handles or a view over the new entities, e.g.
+///
+///     EcsPrefab prefab;
+///     EcsPrefab_Set(prefab, HealthComponent { 100 });
+///     EcsPrefab_Add<PositionComponent>(prefab);
+///
+///     std::vector<EcsEntity> wave(2000);
+///     EcsPrefab_Instantiate(world, prefab, wave);
+///
+public_struct EcsPrefab
+{
+    EcsComponentMask mask;
+
+    // The value of each component, by type, nullptr to value initialise it.
+    std::array<void*, ECS_MAX_COMPONENTS> values {};
+
+    EcsPrefab()                 = default;
+    EcsPrefab(EcsPrefab const&) = delete;
+    EcsPrefab&
+    operator=(EcsPrefab const&) = delete;
+    ~EcsPrefab();
+};
+
+
+/// EcsPrefab_SetComponent - adds type to the prefab if it doesn't have it, and
+/// returns its value, value initialised the first time, for the caller to set.
+public_func void*
+EcsPrefab_SetComponent(EcsPrefab& prefab, EcsComponentType type);
+
+/// EcsPrefab_AddComponent - adds type to the prefab, value initialised in every instance.
+public_func void
+EcsPrefab_AddComponent(EcsPrefab& prefab, EcsComponentType type);
+
+/// EcsPrefab_Clear - removes every component from the prefab.
+public_func void
+EcsPrefab_Clear(EcsPrefab& prefab);
+
+/// EcsPrefab_Instantiate - creates out.size() entities from the prefab, see
+/// Ecs_CreateManyFrom. Every component with a value must be copyable.
+public_func void
+EcsPrefab_Instantiate(EcsWorld& world, EcsPrefab const& prefab, std::span<EcsEntity> out);
+
+
+/// EcsPrefab_Set - gives the prefab a Tp set to value and returns it.
+template <typename Tp>
+Tp*
+EcsPrefab_Set(EcsPrefab& prefab, Tp value)
+{
+    auto* component = Cast(Tp*, EcsPrefab_SetComponent(prefab, Ecs_TypeId<Tp>()));
+    *component      = std::move(value);
+    return component;
+}
+
+template <typename Tp>
+void
+EcsPrefab_Add(EcsPrefab& prefab)
+{
+    EcsPrefab_AddComponent(prefab, Ecs_TypeId<Tp>());
+}
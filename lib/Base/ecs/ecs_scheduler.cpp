@@ -0,0 +1,110 @@
+#include "Base/ecs/ecs_scheduler.h"
+#include <cassert>
+
+
+bool
+EcsSystem_Conflicts(EcsSystem const& a, EcsSystem const& b)
+{
+    if (a.exclusive || b.exclusive)
+    {
+        return true;
+    }
+    return a.writes.intersects(b.reads | b.writes) || b.writes.intersects(a.reads);
+}
+
+
+uint32
+EcsScheduler_Add(EcsScheduler& scheduler, EcsSystem const& system)
+{
+    assert(system.run != nullptr);
+
+    scheduler.systems.push_back(system);
+    scheduler.built = false;
+    return Cast(uint32, scheduler.systems.size() - 1);
+}
+
+
+void
+EcsScheduler_Build(EcsScheduler& scheduler)
+{
+    size_t n = scheduler.systems.size();
+
+    scheduler.dependents.assign(n, {});
+    scheduler.dependency_counts.assign(n, 0);
+    scheduler.tasks.resize(n);
+    scheduler.remaining = std::make_unique<std::atomic<uint32>[]>(n);
+
+    for (uint32 later = 0; later < n; ++later)
+    {
+        scheduler.tasks[later] = { &scheduler, later };
+        for (uint32 earlier = 0; earlier < later; ++earlier)
+        {
+            if (EcsSystem_Conflicts(scheduler.systems[earlier], scheduler.systems[later]))
+            {
+                scheduler.dependents[earlier].push_back(later);
+                scheduler.dependency_counts[later] += 1;
+            }
+        }
+    }
+    scheduler.built = true;
+}
+
+
+static void
+EcsScheduler_RunTask(void* data, uint32 thread_index)
+{
+    (void)thread_index;
+
+    auto&       task      = *Cast(EcsSchedulerTask*, data);
+    auto&       scheduler = *task.scheduler;
+    auto const& system    = scheduler.systems[task.system];
+
+    system.run(*scheduler.world, scheduler.dt, system.context);
+
+    for (auto dependent : scheduler.dependents[task.system])
+    {
+        if (scheduler.remaining[dependent].fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            WorkerPool_Push(*scheduler.pool,
+                            { &EcsScheduler_RunTask, &scheduler.tasks[dependent] });
+        }
+    }
+}
+
+
+void
+EcsScheduler_Run(EcsScheduler& scheduler, EcsWorld& world, float dt, WorkerPool* pool)
+{
+    // NOTE: The order systems were added in is always a valid order to run them in.
+    if (!pool || pool->threads.empty())
+    {
+        for (auto const& system : scheduler.systems)
+        {
+            system.run(world, dt, system.context);
+        }
+        return;
+    }
+
+    if (!scheduler.built)
+    {
+        EcsScheduler_Build(scheduler);
+    }
+
+    scheduler.world = &world;
+    scheduler.pool  = pool;
+    scheduler.dt    = dt;
+
+    for (size_t i = 0; i < scheduler.systems.size(); ++i)
+    {
+        scheduler.remaining[i].store(scheduler.dependency_counts[i], std::memory_order_relaxed);
+    }
+    for (size_t i = 0; i < scheduler.systems.size(); ++i)
+    {
+        if (scheduler.dependency_counts[i] == 0)
+        {
+            WorkerPool_Push(*pool, { &EcsScheduler_RunTask, &scheduler.tasks[i] });
+        }
+    }
+
+    WorkerPool_Wait(*pool);
+}
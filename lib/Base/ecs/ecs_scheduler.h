@@ -0,0 +1,97 @@
+#pragma once
+
+#include "Base/containers/small_vector.h"
+#include "Base/dllexports.h"
+#include "Base/ecs/ecs.h"
+#include "Base/typedefs.h"
+#include "Base/worker_pool.h"
+#include <atomic>
+#include <memory>
+#include <vector>
+
+
+using EcsSystemFunction = void (*)(EcsWorld& world, float dt, void* context);
+
+
+/// EcsSystem - a system and the components it reads and writes.
+///
+/// Two systems conflict if either writes a component the other reads or
+/// writes. Systems that don't conflict may run at the same time, so a system
+/// must declare every component it touches, including ones reached through
+/// Ecs_Get. A system that creates or destroys entities, or adds or removes
+/// components, changes the structure of the world and must be exclusive.
+struct EcsSystem
+{
+    char const*       name;
+    EcsSystemFunction run;
+    void*             context;
+    EcsComponentMask  reads;
+    EcsComponentMask  writes;
+    bool              exclusive;
+};
+
+
+/// EcsSystem_Make - a system that reads the const Tps and writes the others, e.g.
+///
+///     EcsSystem_Make<Position, Velocity const>("integrate", &System_Integrate);
+template <typename... Tps>
+EcsSystem
+EcsSystem_Make(char const* name, EcsSystemFunction run, void* context = nullptr)
+{
+    return { name, run, context, Ecs_ReadMask<Tps...>(), Ecs_WriteMask<Tps...>(), false };
+}
+
+/// EcsSystem_MakeExclusive - a system that conflicts with every other system.
+inline EcsSystem
+EcsSystem_MakeExclusive(char const* name, EcsSystemFunction run, void* context = nullptr)
+{
+    return { name, run, context, {}, {}, true };
+}
+
+public_func bool
+EcsSystem_Conflicts(EcsSystem const& a, EcsSystem const& b);
+
+
+struct EcsScheduler;
+
+struct EcsSchedulerTask
+{
+    EcsScheduler* scheduler;
+    uint32        system;
+};
+
+
+/// EcsScheduler - runs a list of systems, in parallel where their declared
+/// component access allows it.
+///
+/// A system waits for every system added before it that it conflicts with, so
+/// the results are the same as running the systems one after another in the
+/// order they were added.
+public_struct EcsScheduler
+{
+    std::vector<EcsSystem>              systems;
+    std::vector<SmallVector<uint32, 8>> dependents;
+    std::vector<uint32>                 dependency_counts;
+    std::vector<EcsSchedulerTask>       tasks;
+    bool                                built { false };
+
+    // Per run.
+    std::unique_ptr<std::atomic<uint32>[]> remaining;
+    EcsWorld*                              world { nullptr };
+    WorkerPool*                            pool { nullptr };
+    float                                  dt { 0.0f };
+};
+
+
+/// EcsScheduler_Add - adds a system and returns its index. Rebuilds the graph on the next run.
+public_func uint32
+EcsScheduler_Add(EcsScheduler& scheduler, EcsSystem const& system);
+
+/// EcsScheduler_Build - works out which systems each system has to wait for.
+public_func void
+EcsScheduler_Build(EcsScheduler& scheduler);
+
+/// EcsScheduler_Run - runs every system once and returns when they are all done.
+/// Without a pool the systems run one after another on the calling thread.
+public_func void
+EcsScheduler_Run(EcsScheduler& scheduler, EcsWorld& world, float dt, WorkerPool* pool = nullptr);
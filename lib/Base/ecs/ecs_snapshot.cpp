@@ -0,0 +1,190 @@
+#include "Base/ecs/ecs_snapshot.h"
+#include <cassert>
+#include <cstring>
+
+
+static inline size_t
+AlignUp(size_t value, size_t align)
+{
+    return (value + (align - 1)) & ~(align - 1);
+}
+
+
+/// EcsSnapshot_ForEachColumn - calls fn(type, info, offset) for each component
+/// column of a chunk of mask with count rows stored at offset, after its
+/// entities. Returns where the next chunk goes.
+template <typename Fn>
+static size_t
+EcsSnapshot_ForEachColumn(EcsComponentMask const& mask, uint32 count, size_t offset, Fn&& fn)
+{
+    offset += count * sizeof(EcsEntity);
+    for (auto bit : mask)
+    {
+        auto        type = Cast(EcsComponentType, bit);
+        auto const& info = Ecs_GetComponentInfo(type);
+        offset           = AlignUp(offset, ECS_COLUMN_ALIGNMENT);
+        fn(type, info, offset);
+        offset += count * info.size;
+    }
+    return AlignUp(offset, ECS_COLUMN_ALIGNMENT);
+}
+
+
+EcsSnapshot::~EcsSnapshot()
+{
+    EcsSnapshot_Clear(*this);
+    ::operator delete(data, std::align_val_t(ECS_COLUMN_ALIGNMENT));
+}
+
+
+void
+EcsSnapshot_Clear(EcsSnapshot& snapshot)
+{
+    for (auto const& chunk : snapshot.chunks)
+    {
+        auto destroy = [&](EcsComponentType, EcsComponentInfo const& info, size_t offset) {
+            if (!info.trivially_copyable)
+            {
+                info.destroy(snapshot.data + offset, chunk.count);
+            }
+        };
+        auto const& mask = snapshot.masks[chunk.archetype];
+        EcsSnapshot_ForEachColumn(mask, chunk.count, chunk.offset, destroy);
+    }
+    snapshot.chunks.clear();
+    snapshot.size = 0;
+}
+
+
+void
+Ecs_SaveSnapshot(EcsWorld const& world, EcsSnapshot& snapshot)
+{
+    EcsSnapshot_Clear(snapshot);
+
+    snapshot.masks.clear();
+    size_t size = 0;
+    for (auto const& archetype : world.archetypes)
+    {
+        snapshot.masks.push_back(archetype->mask);
+        for (auto const& chunk : archetype->chunks)
+        {
+            snapshot.chunks.push_back({ archetype->index, chunk.count, size });
+            size = EcsSnapshot_ForEachColumn(archetype->mask, chunk.count, size, [](auto...) {});
+        }
+    }
+
+    // Nothing is constructed in data now, so it can simply be replaced.
+    if (size > snapshot.capacity)
+    {
+        ::operator delete(snapshot.data, std::align_val_t(ECS_COLUMN_ALIGNMENT));
+        snapshot.capacity = size + (size / 2);
+        void* data = ::operator new(snapshot.capacity, std::align_val_t(ECS_COLUMN_ALIGNMENT));
+        snapshot.data = Cast(UByte*, data);
+    }
+    snapshot.size = size;
+
+    size_t chunk_idx = 0;
+    for (auto const& archetype : world.archetypes)
+    {
+        for (auto const& chunk : archetype->chunks)
+        {
+            EcsSnapshotChunk const& saved = snapshot.chunks[chunk_idx++];
+            UByte*                  dst   = snapshot.data;
+
+            auto save = [&](EcsComponentType type, EcsComponentInfo const& info, size_t offset) {
+                void const* src = chunk.data + archetype->column_offsets[type];
+                if (info.trivially_copyable)
+                {
+                    std::memcpy(dst + offset, src, chunk.count * info.size);
+                }
+                else
+                {
+                    assert(info.copy && "every component in a snapshot must be copyable");
+                    info.copy(dst + offset, src, chunk.count);
+                }
+            };
+            std::memcpy(dst + saved.offset, chunk.data, chunk.count * sizeof(EcsEntity));
+            EcsSnapshot_ForEachColumn(archetype->mask, chunk.count, saved.offset, save);
+        }
+    }
+
+    snapshot.entities = world.entities;
+}
+
+
+void
+Ecs_LoadSnapshot(EcsWorld& world, EcsSnapshot const& snapshot)
+{
+    assert(world.archetypes.size() >= snapshot.masks.size());
+
+    Ecs_Clear(world);
+
+    uint32 tick = Ecs_ChangeTick(world);
+    for (auto const& saved : snapshot.chunks)
+    {
+        EcsArchetype& archetype = *world.archetypes[saved.archetype];
+        assert(archetype.mask == snapshot.masks[saved.archetype]);
+
+        EcsChunk     chunk { Ecs_AllocateChunk(world), saved.count };
+        UByte const* src = snapshot.data;
+
+        auto load = [&](EcsComponentType type, EcsComponentInfo const& info, size_t offset) {
+            void* dst = chunk.data + archetype.column_offsets[type];
+            if (info.trivially_copyable)
+            {
+                std::memcpy(dst, src + offset, saved.count * info.size);
+            }
+            else
+            {
+                info.copy(dst, src + offset, saved.count);
+            }
+            EcsChunk_MarkChanged(chunk, type, tick);
+        };
+        std::memcpy(chunk.data, src + saved.offset, saved.count * sizeof(EcsEntity));
+        EcsSnapshot_ForEachColumn(archetype.mask, saved.count, saved.offset, load);
+
+        archetype.chunks.push_back(chunk);
+        archetype.entity_count += saved.count;
+    }
+
+    world.entities = snapshot.entities;
+}
+
+
+//////////////////////////////////////////////////////////////////////////////
+
+
+void
+EcsSnapshotRing_Init(EcsSnapshotRing& ring, uint32 capacity)
+{
+    assert(capacity > 0);
+
+    ring.snapshots.clear();
+    for (uint32 i = 0; i < capacity; ++i)
+    {
+        ring.snapshots.push_back(std::make_unique<EcsSnapshot>());
+    }
+    ring.ticks.assign(capacity, ECS_SNAPSHOT_NONE);
+}
+
+
+void
+EcsSnapshotRing_Save(EcsSnapshotRing& ring, EcsWorld const& world, uint64 tick)
+{
+    size_t slot = tick % ring.snapshots.size();
+    Ecs_SaveSnapshot(world, *ring.snapshots[slot]);
+    ring.ticks[slot] = tick;
+}
+
+
+EcsSnapshot const*
+EcsSnapshotRing_Find(EcsSnapshotRing const& ring, uint64 tick)
+{
+    if (ring.snapshots.empty())
+    {
+        return nullptr;
+    }
+
+    size_t slot = tick % ring.snapshots.size();
+    return ring.ticks[slot] == tick ? ring.snapshots[slot].get() : nullptr;
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+#include "Base/dllexports.h"
+#include "Base/ecs/ecs.h"
+#include "Base/typedefs.h"
+#include <memory>
+#include <vector>
+
+
+//////////////////////////////////////////////////////////////////////////////
+//
+// Snapshots of a world, for rolling the simulation back.
+//
+// A snapshot keeps the used rows of every chunk, a column at a time, and the
+// entity index. Saving and loading are a copy per column per chunk, with no
+// per entity work for components that are trivially copyable, the others are
+// copy constructed a column at a time.
+//
+// A snapshot can only be loaded into the world it was taken from. Archetypes
+// are never removed, so any the snapshot has rows in still exist, and loading
+// it puts back exactly the entities, handles and component values it had.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+
+/// EcsSnapshotChunk - where a chunk's rows are in a snapshot's data.
+struct EcsSnapshotChunk
+{
+    uint32 archetype;
+    uint32 count;
+    size_t offset;
+};
+
+
+public_struct EcsSnapshot
+{
+    // Components are constructed in place, each column starting on a cache line.
+    UByte* data { nullptr };
+    size_t size { 0 };
+    size_t capacity { 0 };
+
+    std::vector<EcsSnapshotChunk> chunks;
+    std::vector<EcsComponentMask> masks; // Of every archetype, to check the world against.
+    SlotMap<EcsLocation>          entities;
+
+    EcsSnapshot()                   = default;
+    EcsSnapshot(EcsSnapshot const&) = delete;
+    EcsSnapshot&
+    operator=(EcsSnapshot const&) = delete;
+    ~EcsSnapshot();
+};
+
+
+/// EcsSnapshotRing - the last few snapshots, one per tick.
+public_struct EcsSnapshotRing
+{
+    std::vector<std::unique_ptr<EcsSnapshot>> snapshots;
+    std::vector<uint64>                       ticks; // ECS_SNAPSHOT_NONE if unused.
+};
+
+
+constexpr uint64 ECS_SNAPSHOT_NONE = UINT64_MAX;
+
+
+/// Ecs_SaveSnapshot - copies the world into snapshot, replacing what it held.
+/// Every component type must be copyable.
+public_func void
+Ecs_SaveSnapshot(EcsWorld const& world, EcsSnapshot& snapshot);
+
+/// Ecs_LoadSnapshot - puts the world back the way it was when snapshot was saved.
+///
+/// The snapshot is left as it is, so it can be loaded again. Change ticks
+/// aren't rolled back, every column loaded is marked as changed instead.
+public_func void
+Ecs_LoadSnapshot(EcsWorld& world, EcsSnapshot const& snapshot);
+
+/// EcsSnapshot_Clear - destroys the components the snapshot holds, keeping its storage.
+public_func void
+EcsSnapshot_Clear(EcsSnapshot& snapshot);
+
+
+/// EcsSnapshotRing_Init - room for the last capacity ticks.
+public_func void
+EcsSnapshotRing_Init(EcsSnapshotRing& ring, uint32 capacity);
+
+/// EcsSnapshotRing_Save - saves the world as it is at the start of tick,
+/// overwriting the snapshot from capacity ticks before.
+public_func void
+EcsSnapshotRing_Save(EcsSnapshotRing& ring, EcsWorld const& world, uint64 tick);
+
+/// EcsSnapshotRing_Find - the snapshot of tick, nullptr if it was never saved or overwritten.
+public_func EcsSnapshot const*
+EcsSnapshotRing_Find(EcsSnapshotRing const& ring, uint64 tick);
@@ -0,0 +1,111 @@
+#include "Base/ecs/ecs_tick_rate.h"
+#include <cassert>
+
+
+static std::array<EcsComponentMask, ECS_TICK_RATE_LEVELS>
+EcsTickRate_MakeMasks()
+{
+    return { EcsComponentMask(),
+             Ecs_Mask<EcsTickRateTag<1>>(),
+             Ecs_Mask<EcsTickRateTag<2>>(),
+             Ecs_Mask<EcsTickRateTag<3>>() };
+}
+
+static std::array<EcsComponentMask, ECS_TICK_RATE_LEVELS> const&
+EcsTickRate_Masks()
+{
+    static_assert(ECS_TICK_RATE_LEVELS == 4, "add the new levels to EcsTickRate_MakeMasks.");
+    static auto const masks = EcsTickRate_MakeMasks();
+    return masks;
+}
+
+
+EcsComponentMask
+EcsTickRate_Mask(uint32 level)
+{
+    assert(level < ECS_TICK_RATE_LEVELS);
+    return EcsTickRate_Masks()[level];
+}
+
+
+EcsComponentMask
+EcsTickRate_AllMask()
+{
+    EcsComponentMask all;
+    for (auto const& mask : EcsTickRate_Masks())
+    {
+        all |= mask;
+    }
+    return all;
+}
+
+
+uint32
+EcsTickRate_LevelOf(EcsArchetype const& archetype)
+{
+    auto const& masks = EcsTickRate_Masks();
+    for (uint32 level = 1; level < ECS_TICK_RATE_LEVELS; ++level)
+    {
+        if (archetype.mask.contains(masks[level]))
+        {
+            return level;
+        }
+    }
+    return 0;
+}
+
+
+uint32
+EcsTickRate_EntityLevel(EcsWorld const& world, EcsEntity entity)
+{
+    EcsLocation const* location = world.entities.get(entity);
+    return location ? EcsTickRate_LevelOf(*world.archetypes[location->archetype]) : 0;
+}
+
+
+void
+EcsTickRates_Assign(EcsTickRates&           rates,
+                    EcsWorld&               world,
+                    EcsComponentMask const& include,
+                    EcsTickRatePriority     priority,
+                    void*                   userdata)
+{
+    rates.moves.clear();
+    rates.move_levels.clear();
+
+    // NOTE: Moves are made once every chunk has been looked at, since each
+    // one changes the chunks being iterated.
+    Ecs_ForEachChunk(world, include, [&](EcsArchetype& archetype, EcsChunk& chunk) {
+        rates.levels.assign(chunk.count, 0);
+        priority(world, archetype, chunk, rates.levels, userdata);
+
+        uint32 current  = EcsTickRate_LevelOf(archetype);
+        auto   entities = EcsChunk_Entities(chunk);
+        for (uint32 row = 0; row < chunk.count; ++row)
+        {
+            uint8 level = rates.levels[row];
+            assert(level < ECS_TICK_RATE_LEVELS);
+            if (level != current)
+            {
+                rates.moves.push_back(entities[row]);
+                rates.move_levels.push_back(level);
+            }
+        }
+    });
+
+    EcsComponentMask all = EcsTickRate_AllMask();
+    for (size_t i = 0; i < rates.moves.size(); ++i)
+    {
+        EcsEntity          entity   = rates.moves[i];
+        EcsLocation const& location = *world.entities.get(entity);
+        EcsComponentMask   mask     = world.archetypes[location.archetype]->mask;
+        for (auto type : all)
+        {
+            mask.reset(type);
+        }
+        mask |= EcsTickRate_Mask(rates.move_levels[i]);
+
+        [[maybe_unused]] bool changed = Ecs_ChangeComponents(world, entity, mask);
+        assert(changed);
+    }
+}
@@ -0,0 +1,144 @@
+#pragma once
+
+#include "Base/dllexports.h"
+#include "Base/ecs/ecs.h"
+#include "Base/ecs/ecs_view.h"
+#include "Base/typedefs.h"
+#include <array>
+#include <span>
+#include <vector>
+
+
+//////////////////////////////////////////////////////////////////////////////
+//
+// Tick rate levels, for updating distant or idle entities less often.
+//
+// An entity at level k is updated every 2^k simulation steps, with a dt of
+// 2^k steps. Level 0, every step, is having no tag, so new entities start at
+// full rate. The other levels are tag components, so each chunk belongs to a
+// single level and a system skips the levels that aren't due a chunk at a
+// time, without looking at their entities.
+//
+// Every level is due on the steps that are a multiple of its period, so on
+// the steps that are a multiple of the longest period, the sync steps, every
+// level has just caught up. Entities only change level on a sync step, which
+// keeps the dt each of them sees equal to the time since it was last updated.
+// Everything depends on the step alone, so rolling back and replaying steps
+// comes out the same.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+
+constexpr uint32 ECS_TICK_RATE_LEVELS = 4;
+
+
+/// EcsTickRateTag - marks an entity updated every 2^Level steps.
+template <uint32 Level>
+struct EcsTickRateTag
+{
+    static_assert(Level > 0 && Level < ECS_TICK_RATE_LEVELS, "level 0 has no tag.");
+};
+
+
+/// EcsTickRatePriority - fills in the level each row of the chunk should be at.
+using EcsTickRatePriority = void (*)(EcsWorld&           world,
+                                     EcsArchetype const& archetype,
+                                     EcsChunk&           chunk,
+                                     std::span<uint8>    levels,
+                                     void*               userdata);
+
+
+/// EcsTickRates - scratch space for moving entities between levels.
+public_struct EcsTickRates
+{
+    std::vector<uint8>     levels;
+    std::vector<EcsEntity> moves;
+    std::vector<uint8>     move_levels;
+};
+
+
+/// EcsTickRate_Mask - the tag of level, empty for level 0.
+public_func EcsComponentMask
+EcsTickRate_Mask(uint32 level);
+
+/// EcsTickRate_AllMask - the tags of every level.
+public_func EcsComponentMask
+EcsTickRate_AllMask();
+
+/// EcsTickRate_LevelOf - the level of the archetype's entities.
+public_func uint32
+EcsTickRate_LevelOf(EcsArchetype const& archetype);
+
+/// EcsTickRate_EntityLevel - the level of the entity, 0 if it is stale.
+public_func uint32
+EcsTickRate_EntityLevel(EcsWorld const& world, EcsEntity entity);
+
+/// EcsTickRates_Assign - on a sync step, calls priority for every chunk whose
+/// archetype has all of include and moves the entities whose level changed.
+/// Moves entities between archetypes, so it can't run alongside other systems.
+public_func void
+EcsTickRates_Assign(EcsTickRates&           rates,
+                    EcsWorld&               world,
+                    EcsComponentMask const& include,
+                    EcsTickRatePriority     priority,
+                    void*                   userdata);
+
+
+inline uint32
+EcsTickRate_Period(uint32 level)
+{
+    return 1u << level;
+}
+
+/// EcsTickRate_Due - true if level is updated on step.
+inline bool
+EcsTickRate_Due(uint64 step, uint32 level)
+{
+    return (step & (EcsTickRate_Period(level) - 1)) == 0;
+}
+
+/// EcsTickRate_IsSync - true if every level is due on step, see EcsTickRates_Assign.
+inline bool
+EcsTickRate_IsSync(uint64 step)
+{
+    return EcsTickRate_Due(step, ECS_TICK_RATE_LEVELS - 1);
+}
+
+/// EcsTickRate_Alpha - how far to interpolate between the last two states of
+/// an entity at level, for a frame remainder_t past the last step run, where
+/// step is the next one to run and step_t the length of one.
+///
+/// At level 0 this is remainder_t / step_t, the usual. Higher levels spread
+/// the interpolation over their period, so slow entities still move smoothly.
+inline float
+EcsTickRate_Alpha(uint64 step, uint32 level, float remainder_t, float step_t)
+{
+    uint32 mask = EcsTickRate_Period(level) - 1;
+    float  into = Cast(float, (step - 1) & mask) + (remainder_t / step_t);
+    return into / Cast(float, mask + 1);
+}
+
+
+/// EcsTickRate_MakeViews - a view over the entities of each level, e.g.
+///
+///     static auto views = EcsTickRate_MakeViews<Position, Velocity const>();
+///     for (uint32 level = 0; level < ECS_TICK_RATE_LEVELS; ++level)
+///     {
+///         if (EcsTickRate_Due(step, level))
+///         {
+///             float dt = SIM_PERIOD * EcsTickRate_Period(level);
+///             views[level].each(world, [dt](Position& p, Velocity const& v) { ... });
+///         }
+///     }
+template <typename... Tps>
+std::array<EcsView<Tps...>, ECS_TICK_RATE_LEVELS>
+EcsTickRate_MakeViews()
+{
+    std::array<EcsView<Tps...>, ECS_TICK_RATE_LEVELS> views;
+    views[0].exclude = EcsTickRate_AllMask();
+    for (uint32 level = 1; level < ECS_TICK_RATE_LEVELS; ++level)
+    {
+        views[level].include |= EcsTickRate_Mask(level);
+    }
+    return views;
+}
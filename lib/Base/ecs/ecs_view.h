@@ -0,0 +1,306 @@
+#pragma once
+
+#include "Base/containers/small_vector.h"
+#include "Base/dllexports.h"
+#include "Base/ecs/ecs.h"
+#include "Base/typedefs.h"
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <span>
+#include <tuple>
+#include <type_traits>
+
+
+/// EcsView - a cached query over the archetypes that have all of Tps and none of exclude.
+///
+/// The matching archetypes, and where each of Tps lives in their chunks, are
+/// remembered between calls. Archetypes are never removed from a world, so
+/// when its structure_version changes only the archetypes created since the
+/// last call are tested. Iterating is then a loop over the matching chunks
+/// with no per entity checks, e.g.
+///
+///     static EcsView<Position, Velocity const> view;
+///     view.each(world, [](Position& p, Velocity const& v) { p.x += v.x; });
+///
+/// Mark the components a system only reads as const. The columns of the others
+/// are marked as changed in every chunk visited.
+///
+/// each_chunk_changed and each_changed skip the chunks where none of the
+/// changed_filter columns, all of Tps by default, were written since the
+/// view's last changed iteration.
+template <typename... Tps>
+struct EcsView
+{
+    static constexpr size_t NUM_COMPONENTS = sizeof...(Tps);
+
+    struct Match
+    {
+        uint32                             archetype;
+        std::array<uint32, NUM_COMPONENTS> offsets;
+    };
+
+    // Data members
+    //
+    EcsComponentMask       include { Ecs_Mask<Tps...>() };
+    EcsComponentMask       exclude;
+    SmallVector<Match, 16> matches;
+    uint64                 world_id { 0 };
+    size_t                 archetypes_checked { 0 };
+    uint64                 version { UINT64_MAX };
+    EcsComponentMask       changed_filter { Ecs_Mask<Tps...>() };
+    uint32                 last_tick { 0 };
+
+    // Constructors.
+    EcsView() = default;
+
+    explicit EcsView(EcsComponentMask const& exclude)
+        : exclude(exclude)
+    {
+    }
+
+    /// reads - the components a system using this view reads, for EcsSystem.
+    static EcsComponentMask
+    reads()
+    {
+        return Ecs_ReadMask<Tps...>();
+    }
+
+    /// writes - the components a system using this view writes, for EcsSystem.
+    static EcsComponentMask
+    writes()
+    {
+        return Ecs_WriteMask<Tps...>();
+    }
+
+
+    /// refresh - brings the set of matching archetypes up to date with w.
+    void
+    refresh(EcsWorld const& w)
+    {
+        if (world_id != w.id)
+        {
+            world_id = w.id;
+            matches.clear();
+            archetypes_checked = 0;
+            last_tick          = 0;
+        }
+        else if (version == w.structure_version)
+        {
+            return;
+        }
+
+        for (; archetypes_checked < w.archetypes.size(); ++archetypes_checked)
+        {
+            auto const& archetype = *w.archetypes[archetypes_checked];
+            if (archetype.mask.contains(include) && !archetype.mask.intersects(exclude))
+            {
+                matches.push_back({ archetype.index,
+                                    { archetype.column_offsets[Ecs_TypeId<Tps>()]... } });
+            }
+        }
+        version = w.structure_version;
+    }
+
+    /// each_chunk - calls fn(chunk, std::span<Tps>...) for every non empty matching chunk.
+    template <typename Fn>
+    void
+    each_chunk(EcsWorld& w, Fn&& fn)
+    {
+        refresh(w);
+
+        uint32 tick = Ecs_ChangeTick(w);
+        for (auto const& match : matches)
+        {
+            for (auto& chunk : w.archetypes[match.archetype]->chunks)
+            {
+                call_chunk(fn, chunk, match, tick, std::index_sequence_for<Tps...> {});
+            }
+        }
+    }
+
+    /// each_chunk_changed - each_chunk, for the chunks with changed_filter columns
+    /// written since the last call.
+    template <typename Fn>
+    void
+    each_chunk_changed(EcsWorld& w, Fn&& fn)
+    {
+        refresh(w);
+
+        uint32 since = last_tick;
+        uint32 now   = Ecs_AdvanceTick(w);
+        for (auto const& match : matches)
+        {
+            for (auto& chunk : w.archetypes[match.archetype]->chunks)
+            {
+                if (EcsChunk_ChangedSince(chunk, changed_filter, since))
+                {
+                    call_chunk(fn, chunk, match, now, std::index_sequence_for<Tps...> {});
+                }
+            }
+        }
+        // NOTE: Our own writes are stamped with now, so they don't count as changes next time.
+        last_tick = now;
+    }
+
+    /// each_changed - each, for the entities in chunks each_chunk_changed would visit.
+    template <typename Fn>
+    void
+    each_changed(EcsWorld& w, Fn&& fn)
+    {
+        each_chunk_changed(w, [&](EcsChunk& chunk, std::span<Tps>... columns) {
+            for (uint32 row = 0; row < chunk.count; ++row)
+            {
+                fn(columns[row]...);
+            }
+        });
+    }
+
+    /// each - calls fn(Tps&...) for every matching entity.
+    template <typename Fn>
+    void
+    each(EcsWorld& w, Fn&& fn)
+    {
+        each_chunk(w, [&](EcsChunk& chunk, std::span<Tps>... columns) {
+            for (uint32 row = 0; row < chunk.count; ++row)
+            {
+                fn(columns[row]...);
+            }
+        });
+    }
+
+    /// count - the number of matching entities.
+    size_t
+    count(EcsWorld& w)
+    {
+        refresh(w);
+
+        size_t n = 0;
+        for (auto const& match : matches)
+        {
+            n += w.archetypes[match.archetype]->entity_count;
+        }
+        return n;
+    }
+
+
+    // Iterators.
+    /// iterator - yields a tuple of references to the components of each matching entity.
+    struct iterator
+    {
+        EcsView*            view;
+        EcsWorld*           w;
+        size_t              match_idx;
+        size_t              chunk_idx;
+        uint32              row;
+        uint32              count;
+        std::tuple<Tps*...> columns;
+
+        std::tuple<Tps&...>
+        operator*() const noexcept
+        {
+            return std::apply([this](auto*... column) { return std::tuple<Tps&...>(column[row]...); },
+                              columns);
+        }
+
+        iterator&
+        operator++() noexcept
+        {
+            row += 1;
+            if (row == count)
+            {
+                chunk_idx += 1;
+                seek();
+            }
+            return *this;
+        }
+
+        bool
+        operator==(iterator const& other) const noexcept
+        {
+            return match_idx == other.match_idx && chunk_idx == other.chunk_idx && row == other.row;
+        }
+
+        /// seek - moves to the first row of the next non empty chunk, starting at chunk_idx.
+        void
+        seek() noexcept
+        {
+            row = 0;
+            for (; match_idx < view->matches.size(); ++match_idx, chunk_idx = 0)
+            {
+                auto const& match  = view->matches[match_idx];
+                auto&       chunks = w->archetypes[match.archetype]->chunks;
+                if (chunk_idx < chunks.size())
+                {
+                    auto& chunk = chunks[chunk_idx];
+                    count       = chunk.count;
+                    columns     = view->columns_of(chunk, match, std::index_sequence_for<Tps...> {});
+                    view->mark_writes(chunk, Ecs_ChangeTick(*w));
+                    return;
+                }
+            }
+            chunk_idx = 0;
+            count     = 0;
+        }
+    };
+
+    struct Range
+    {
+        iterator first;
+        iterator last;
+
+        iterator
+        begin() const noexcept
+        {
+            return first;
+        }
+
+        iterator
+        end() const noexcept
+        {
+            return last;
+        }
+    };
+
+    /// iterate - a range over every matching entity, for use in range based for loops.
+    Range
+    iterate(EcsWorld& w)
+    {
+        refresh(w);
+
+        iterator first { this, &w, 0, 0, 0, 0, {} };
+        first.seek();
+        iterator last { this, &w, matches.size(), 0, 0, 0, {} };
+        return { first, last };
+    }
+
+
+    // Implementation.
+    //
+    static void
+    mark_writes(EcsChunk& chunk, uint32 tick)
+    {
+        ([&] {
+            if constexpr (!std::is_const_v<Tps>)
+            {
+                EcsChunk_MarkChanged(chunk, Ecs_TypeId<Tps>(), tick);
+            }
+        }(),
+         ...);
+    }
+
+    template <size_t... Is>
+    std::tuple<Tps*...>
+    columns_of(EcsChunk& chunk, Match const& match, std::index_sequence<Is...>) const noexcept
+    {
+        return { Cast(Tps*, Cast(void*, chunk.data + match.offsets[Is]))... };
+    }
+
+    template <typename Fn, size_t... Is>
+    static void
+    call_chunk(Fn& fn, EcsChunk& chunk, Match const& match, uint32 tick, std::index_sequence<Is...>)
+    {
+        mark_writes(chunk, tick);
+        fn(chunk, std::span<Tps>(Cast(Tps*, Cast(void*, chunk.data + match.offsets[Is])), chunk.count)...);
+    }
+};
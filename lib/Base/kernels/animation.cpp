@@ -0,0 +1,184 @@
+#include "Base/kernels/animation.h"
+#include <algorithm>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64)
+#define ANIMATION_X86 1
+#include <emmintrin.h>
+#endif
+
+// The SIMD kernel rounds the multiply and the subtract apart, so the scalar
+// one mustn't be contracted into a fused multiply add, whatever flags this
+// file is built with. MSVC doesn't contract under its default /fp:precise.
+#if defined(__clang__)
+#pragma STDC FP_CONTRACT OFF
+#elif defined(__GNUC__)
+#pragma GCC optimize("fp-contract=off")
+#endif
+
+
+/// Animation_AdvanceRow - the scalar kernel for row i.
+static inline void
+Animation_AdvanceRow(AnimationColumns const& columns, size_t i, float dt)
+{
+    if (!columns.animate[i])
+    {
+        columns.anim_t[i] = 0.0f;
+        columns.frame[i]  = 0;
+        columns.looped[i] = 0;
+        return;
+    }
+
+    float f = columns.frame_t[i];
+    float t = columns.anim_t[i] + dt;
+
+    // The quotient can round either way across a whole frame, which leaves the
+    // time left over a little under zero or a little over a frame.
+    Int   steps = Cast(Int, t / f);
+    float rest  = t - (Cast(float, steps) * f);
+    if (rest < 0.0f)
+    {
+        steps -= 1;
+        rest += f;
+    }
+    if (rest >= f)
+    {
+        steps += 1;
+        rest -= f;
+    }
+
+    Int count = columns.n_sprites[i];
+    Int next  = columns.frame[i] + steps;
+    Int laps  = next / count;
+
+    columns.anim_t[i] = rest;
+    columns.frame[i]  = next - (laps * count);
+    columns.looped[i] = Cast(UByte, std::min(laps, 255));
+}
+
+
+void
+Animation_AdvanceScalar(AnimationColumns const& columns, float dt)
+{
+    for (size_t i = 0; i < columns.n; ++i)
+    {
+        Animation_AdvanceRow(columns, i, dt);
+    }
+}
+
+
+#if defined(ANIMATION_X86)
+
+// Each step of the scalar kernel as a select over 4 rows. Frame counts are
+// carried as floats, which hold every integer below 2^24 exactly, so the
+// division and remainder match the scalar integer ones. Rows that aren't
+// animating are worked out as well, possibly dividing by zero, and zeroed at
+// the end.
+
+void
+Animation_AdvanceSse2(AnimationColumns const& columns, float dt)
+{
+    __m128 const  step  = _mm_set1_ps(dt);
+    __m128 const  one   = _mm_set1_ps(1.0f);
+    __m128 const  zero  = _mm_setzero_ps();
+    __m128 const  max   = _mm_set1_ps(255.0f);
+    __m128i const izero = _mm_setzero_si128();
+
+    size_t i = 0;
+    for (; i + 4 <= columns.n; i += 4)
+    {
+        int32 flags;
+        std::memcpy(&flags, columns.animate + i, sizeof(flags));
+        __m128i on = _mm_cvtsi32_si128(flags);
+        on         = _mm_unpacklo_epi16(_mm_unpacklo_epi8(on, izero), izero);
+        on         = _mm_xor_si128(_mm_cmpeq_epi32(on, izero), _mm_set1_epi32(-1));
+
+        __m128 f = _mm_loadu_ps(columns.frame_t + i);
+        __m128 t = _mm_add_ps(_mm_loadu_ps(columns.anim_t + i), step);
+
+        __m128 steps = _mm_cvtepi32_ps(_mm_cvttps_epi32(_mm_div_ps(t, f)));
+        __m128 rest  = _mm_sub_ps(t, _mm_mul_ps(steps, f));
+
+        __m128 behind = _mm_cmplt_ps(rest, zero);
+        steps         = _mm_sub_ps(steps, _mm_and_ps(behind, one));
+        rest          = _mm_add_ps(rest, _mm_and_ps(behind, f));
+
+        __m128 ahead = _mm_cmpge_ps(rest, f);
+        steps        = _mm_add_ps(steps, _mm_and_ps(ahead, one));
+        rest         = _mm_sub_ps(rest, _mm_and_ps(ahead, f));
+
+        __m128i frame = _mm_loadu_si128(reinterpret_cast<__m128i const*>(columns.frame + i));
+        __m128i n_sprites =
+            _mm_loadu_si128(reinterpret_cast<__m128i const*>(columns.n_sprites + i));
+
+        __m128 count = _mm_cvtepi32_ps(n_sprites);
+        __m128 next  = _mm_add_ps(_mm_cvtepi32_ps(frame), steps);
+        __m128 laps  = _mm_cvtepi32_ps(_mm_cvttps_epi32(_mm_div_ps(next, count)));
+        next         = _mm_sub_ps(next, _mm_mul_ps(laps, count));
+        laps         = _mm_min_ps(laps, max);
+
+        __m128i frames = _mm_and_si128(_mm_cvttps_epi32(next), on);
+        __m128i looped = _mm_and_si128(_mm_cvttps_epi32(laps), on);
+        looped         = _mm_packus_epi16(_mm_packs_epi32(looped, looped), izero);
+
+        _mm_storeu_ps(columns.anim_t + i, _mm_and_ps(rest, _mm_castsi128_ps(on)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(columns.frame + i), frames);
+
+        int32 bytes = _mm_cvtsi128_si32(looped);
+        std::memcpy(columns.looped + i, &bytes, sizeof(bytes));
+    }
+
+    for (; i < columns.n; ++i)
+    {
+        Animation_AdvanceRow(columns, i, dt);
+    }
+}
+
+#endif
+
+
+void
+Animation_Advance(AnimationColumns const& columns, float dt)
+{
+#if defined(ANIMATION_X86)
+    Animation_AdvanceSse2(columns, dt);
+#else
+    Animation_AdvanceScalar(columns, dt);
+#endif
+}
+
+
+size_t
+Animation_DispatchLooped(UByte const* looped, size_t n, AnimationEventFunction fn, void* context)
+{
+    size_t count = 0;
+    size_t i     = 0;
+
+    // Most rows don't wrap, skip them eight at a time.
+    for (; i + 8 <= n; i += 8)
+    {
+        uint64 word;
+        std::memcpy(&word, looped + i, sizeof(word));
+        if (word == 0)
+        {
+            continue;
+        }
+        for (size_t j = i; j < i + 8; ++j)
+        {
+            if (looped[j])
+            {
+                fn(context, Cast(uint32, j), looped[j]);
+                count += 1;
+            }
+        }
+    }
+    for (; i < n; ++i)
+    {
+        if (looped[i])
+        {
+            fn(context, Cast(uint32, i), looped[i]);
+            count += 1;
+        }
+    }
+    return count;
+}
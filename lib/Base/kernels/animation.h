@@ -0,0 +1,61 @@
+#pragma once
+
+#include "Base/dllexports.h"
+#include "Base/typedefs.h"
+#include <cstddef>
+
+
+/// AnimationColumns - the timing fields of n sprite animations, one array per field.
+///
+/// Every row needs frame_t > 0 and n_sprites > 0, whether it animates or not.
+struct AnimationColumns
+{
+    bool const*  animate;   // Rows that aren't animating are reset to their first frame.
+    Int const*   n_sprites; // Frames in the loop.
+    float const* frame_t;   // Seconds per frame.
+    float*       anim_t;    // Seconds into the current frame.
+    Int*         frame;
+    UByte*       looped; // Written, times the loop wrapped during the last advance.
+    size_t       n;
+};
+
+
+/// AnimationKernel - moves every animation in columns on by dt seconds.
+using AnimationKernel = void (*)(AnimationColumns const& columns, float dt);
+
+/// AnimationEventFunction - called for a row whose animation wrapped laps times.
+using AnimationEventFunction = void (*)(void* context, uint32 row, uint32 laps);
+
+
+/// Animation_AdvanceScalar - the reference kernel, one row at a time.
+///
+/// The frame is worked out in closed form rather than stepped one frame at a
+/// time, so the cost doesn't depend on dt or on how many frames go by.
+///
+///     steps  = floor((anim_t + dt) / frame_t)
+///     anim_t = anim_t + dt - steps * frame_t
+///     frame  = (frame + steps) % n_sprites
+///     looped = min((frame + steps) / n_sprites, 255)
+///
+/// NOTE: The SIMD kernel counts frames in single precision, so frame + steps
+/// has to stay below 2^24. animation.cpp turns off contraction into fused
+/// multiply adds, so both kernels give the same results.
+public_func void
+Animation_AdvanceScalar(AnimationColumns const& columns, float dt);
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64)
+/// Animation_AdvanceSse2 - 4 rows per instruction, without a branch per row.
+public_func void
+Animation_AdvanceSse2(AnimationColumns const& columns, float dt);
+#endif
+
+/// Animation_Advance - the fastest kernel this build has.
+public_func void
+Animation_Advance(AnimationColumns const& columns, float dt);
+
+/// Animation_DispatchLooped - calls fn for each row that wrapped during the last
+/// advance, in row order. Returns how many rows that was.
+///
+/// Kept apart from the advance so the rare event doesn't cost every row a branch.
+public_func size_t
+Animation_DispatchLooped(UByte const* looped, size_t n, AnimationEventFunction fn, void* context);
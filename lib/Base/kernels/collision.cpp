@@ -0,0 +1,359 @@
+#include "Base/kernels/collision.h"
+#include "Base/platform/platform.h"
+#include <algorithm>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64)
+#define COLLISION_X86 1
+#include <immintrin.h>
+#endif
+
+// MSVC lets any function use any instruction set, GCC and Clang need telling.
+#if defined(COLLISION_X86) && !defined(_MSC_VER)
+#define COLLISION_TARGET(isa) __attribute__((target(isa)))
+#else
+#define COLLISION_TARGET(isa)
+#endif
+
+
+static inline void
+Collision_ClearHits(uint64* hits, size_t n)
+{
+    std::fill(hits, hits + Collision_HitWords(n), uint64(0));
+}
+
+/// Collision_SetHits - ors in the hits of the tests from i, which the SIMD
+/// kernels take 4 or 8 at a time so they never straddle a word.
+static inline void
+Collision_SetHits(uint64* hits, size_t i, uint32 mask)
+{
+    hits[i / 64] |= Cast(uint64, mask) << (i % 64);
+}
+
+// The same as minps and maxps, down to which operand a NaN gives back.
+static inline float
+Collision_Min(float a, float b)
+{
+    return a < b ? a : b;
+}
+
+static inline float
+Collision_Max(float a, float b)
+{
+    return a > b ? a : b;
+}
+
+
+static inline bool
+Collision_OverlapRow(CollisionBoxes const& a, CollisionBoxes const& b, size_t i)
+{
+    return a.x[i] < b.x[i] + b.w[i] && b.x[i] < a.x[i] + a.w[i] && a.y[i] < b.y[i] + b.h[i]
+           && b.y[i] < a.y[i] + a.h[i];
+}
+
+static inline bool
+Collision_PointInBoxRow(float const* px, float const* py, CollisionBoxes const& boxes, size_t i)
+{
+    return boxes.x[i] <= px[i] && px[i] < boxes.x[i] + boxes.w[i] && boxes.y[i] <= py[i]
+           && py[i] < boxes.y[i] + boxes.h[i];
+}
+
+static inline bool
+Collision_RayRow(CollisionRay const& ray, CollisionBoxes const& boxes, size_t i)
+{
+    float x0 = (boxes.x[i] - ray.origin_x) * ray.inv_dir_x;
+    float x1 = ((boxes.x[i] + boxes.w[i]) - ray.origin_x) * ray.inv_dir_x;
+    float y0 = (boxes.y[i] - ray.origin_y) * ray.inv_dir_y;
+    float y1 = ((boxes.y[i] + boxes.h[i]) - ray.origin_y) * ray.inv_dir_y;
+
+    float enter = Collision_Max(Collision_Max(Collision_Min(x0, x1), Collision_Min(y0, y1)), 0.0f);
+    float leave = Collision_Min(Collision_Min(Collision_Max(x0, x1), Collision_Max(y0, y1)),
+                                ray.t_max);
+    return enter <= leave;
+}
+
+
+void
+Collision_OverlapScalar(CollisionBoxes const& a, CollisionBoxes const& b, size_t n, uint64* hits)
+{
+    Collision_ClearHits(hits, n);
+    for (size_t i = 0; i < n; ++i)
+    {
+        Collision_SetHits(hits, i, Collision_OverlapRow(a, b, i));
+    }
+}
+
+
+void
+Collision_PointInBoxScalar(float const*          px,
+                           float const*          py,
+                           CollisionBoxes const& boxes,
+                           size_t                n,
+                           uint64*               hits)
+{
+    Collision_ClearHits(hits, n);
+    for (size_t i = 0; i < n; ++i)
+    {
+        Collision_SetHits(hits, i, Collision_PointInBoxRow(px, py, boxes, i));
+    }
+}
+
+
+void
+Collision_RayScalar(CollisionRay const& ray, CollisionBoxes const& boxes, size_t n, uint64* hits)
+{
+    Collision_ClearHits(hits, n);
+    for (size_t i = 0; i < n; ++i)
+    {
+        Collision_SetHits(hits, i, Collision_RayRow(ray, boxes, i));
+    }
+}
+
+
+#if defined(COLLISION_X86)
+
+// Each kernel makes the scalar comparisons a lane at a time, ands them into a
+// mask per box and moves the sign bits of the mask into the hit words. The
+// tail, fewer boxes than lanes, uses the scalar row tests.
+
+void
+Collision_OverlapSse2(CollisionBoxes const& a, CollisionBoxes const& b, size_t n, uint64* hits)
+{
+    Collision_ClearHits(hits, n);
+
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        __m128 ax = _mm_loadu_ps(a.x + i), ay = _mm_loadu_ps(a.y + i);
+        __m128 bx = _mm_loadu_ps(b.x + i), by = _mm_loadu_ps(b.y + i);
+        __m128 ax1 = _mm_add_ps(ax, _mm_loadu_ps(a.w + i));
+        __m128 ay1 = _mm_add_ps(ay, _mm_loadu_ps(a.h + i));
+        __m128 bx1 = _mm_add_ps(bx, _mm_loadu_ps(b.w + i));
+        __m128 by1 = _mm_add_ps(by, _mm_loadu_ps(b.h + i));
+
+        __m128 hit = _mm_and_ps(_mm_cmplt_ps(ax, bx1), _mm_cmplt_ps(bx, ax1));
+        hit        = _mm_and_ps(hit, _mm_and_ps(_mm_cmplt_ps(ay, by1), _mm_cmplt_ps(by, ay1)));
+        Collision_SetHits(hits, i, Cast(uint32, _mm_movemask_ps(hit)));
+    }
+    for (; i < n; ++i)
+    {
+        Collision_SetHits(hits, i, Collision_OverlapRow(a, b, i));
+    }
+}
+
+
+void
+Collision_PointInBoxSse2(float const*          px,
+                         float const*          py,
+                         CollisionBoxes const& boxes,
+                         size_t                n,
+                         uint64*               hits)
+{
+    Collision_ClearHits(hits, n);
+
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        __m128 x  = _mm_loadu_ps(px + i), y = _mm_loadu_ps(py + i);
+        __m128 x0 = _mm_loadu_ps(boxes.x + i), y0 = _mm_loadu_ps(boxes.y + i);
+        __m128 x1 = _mm_add_ps(x0, _mm_loadu_ps(boxes.w + i));
+        __m128 y1 = _mm_add_ps(y0, _mm_loadu_ps(boxes.h + i));
+
+        __m128 hit = _mm_and_ps(_mm_cmple_ps(x0, x), _mm_cmplt_ps(x, x1));
+        hit        = _mm_and_ps(hit, _mm_and_ps(_mm_cmple_ps(y0, y), _mm_cmplt_ps(y, y1)));
+        Collision_SetHits(hits, i, Cast(uint32, _mm_movemask_ps(hit)));
+    }
+    for (; i < n; ++i)
+    {
+        Collision_SetHits(hits, i, Collision_PointInBoxRow(px, py, boxes, i));
+    }
+}
+
+
+void
+Collision_RaySse2(CollisionRay const& ray, CollisionBoxes const& boxes, size_t n, uint64* hits)
+{
+    Collision_ClearHits(hits, n);
+
+    __m128 const ox    = _mm_set1_ps(ray.origin_x);
+    __m128 const oy    = _mm_set1_ps(ray.origin_y);
+    __m128 const idx   = _mm_set1_ps(ray.inv_dir_x);
+    __m128 const idy   = _mm_set1_ps(ray.inv_dir_y);
+    __m128 const t_max = _mm_set1_ps(ray.t_max);
+    __m128 const zero  = _mm_setzero_ps();
+
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        __m128 bx = _mm_loadu_ps(boxes.x + i), by = _mm_loadu_ps(boxes.y + i);
+        __m128 x0 = _mm_mul_ps(_mm_sub_ps(bx, ox), idx);
+        __m128 x1 = _mm_mul_ps(_mm_sub_ps(_mm_add_ps(bx, _mm_loadu_ps(boxes.w + i)), ox), idx);
+        __m128 y0 = _mm_mul_ps(_mm_sub_ps(by, oy), idy);
+        __m128 y1 = _mm_mul_ps(_mm_sub_ps(_mm_add_ps(by, _mm_loadu_ps(boxes.h + i)), oy), idy);
+
+        __m128 enter = _mm_max_ps(_mm_max_ps(_mm_min_ps(x0, x1), _mm_min_ps(y0, y1)), zero);
+        __m128 leave = _mm_min_ps(_mm_min_ps(_mm_max_ps(x0, x1), _mm_max_ps(y0, y1)), t_max);
+        Collision_SetHits(hits, i, Cast(uint32, _mm_movemask_ps(_mm_cmple_ps(enter, leave))));
+    }
+    for (; i < n; ++i)
+    {
+        Collision_SetHits(hits, i, Collision_RayRow(ray, boxes, i));
+    }
+}
+
+
+COLLISION_TARGET("avx2") void
+Collision_OverlapAvx2(CollisionBoxes const& a, CollisionBoxes const& b, size_t n, uint64* hits)
+{
+    Collision_ClearHits(hits, n);
+
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        __m256 ax = _mm256_loadu_ps(a.x + i), ay = _mm256_loadu_ps(a.y + i);
+        __m256 bx = _mm256_loadu_ps(b.x + i), by = _mm256_loadu_ps(b.y + i);
+        __m256 ax1 = _mm256_add_ps(ax, _mm256_loadu_ps(a.w + i));
+        __m256 ay1 = _mm256_add_ps(ay, _mm256_loadu_ps(a.h + i));
+        __m256 bx1 = _mm256_add_ps(bx, _mm256_loadu_ps(b.w + i));
+        __m256 by1 = _mm256_add_ps(by, _mm256_loadu_ps(b.h + i));
+
+        __m256 hit = _mm256_cmp_ps(ax, bx1, _CMP_LT_OQ);
+        hit        = _mm256_and_ps(hit, _mm256_cmp_ps(bx, ax1, _CMP_LT_OQ));
+        hit        = _mm256_and_ps(hit, _mm256_cmp_ps(ay, by1, _CMP_LT_OQ));
+        hit        = _mm256_and_ps(hit, _mm256_cmp_ps(by, ay1, _CMP_LT_OQ));
+        Collision_SetHits(hits, i, Cast(uint32, _mm256_movemask_ps(hit)));
+    }
+    for (; i < n; ++i)
+    {
+        Collision_SetHits(hits, i, Collision_OverlapRow(a, b, i));
+    }
+}
+
+
+COLLISION_TARGET("avx2") void
+Collision_PointInBoxAvx2(float const*          px,
+                         float const*          py,
+                         CollisionBoxes const& boxes,
+                         size_t                n,
+                         uint64*               hits)
+{
+    Collision_ClearHits(hits, n);
+
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        __m256 x  = _mm256_loadu_ps(px + i), y = _mm256_loadu_ps(py + i);
+        __m256 x0 = _mm256_loadu_ps(boxes.x + i), y0 = _mm256_loadu_ps(boxes.y + i);
+        __m256 x1 = _mm256_add_ps(x0, _mm256_loadu_ps(boxes.w + i));
+        __m256 y1 = _mm256_add_ps(y0, _mm256_loadu_ps(boxes.h + i));
+
+        __m256 hit = _mm256_cmp_ps(x0, x, _CMP_LE_OQ);
+        hit        = _mm256_and_ps(hit, _mm256_cmp_ps(x, x1, _CMP_LT_OQ));
+        hit        = _mm256_and_ps(hit, _mm256_cmp_ps(y0, y, _CMP_LE_OQ));
+        hit        = _mm256_and_ps(hit, _mm256_cmp_ps(y, y1, _CMP_LT_OQ));
+        Collision_SetHits(hits, i, Cast(uint32, _mm256_movemask_ps(hit)));
+    }
+    for (; i < n; ++i)
+    {
+        Collision_SetHits(hits, i, Collision_PointInBoxRow(px, py, boxes, i));
+    }
+}
+
+
+COLLISION_TARGET("avx2") void
+Collision_RayAvx2(CollisionRay const& ray, CollisionBoxes const& boxes, size_t n, uint64* hits)
+{
+    Collision_ClearHits(hits, n);
+
+    __m256 const ox    = _mm256_set1_ps(ray.origin_x);
+    __m256 const oy    = _mm256_set1_ps(ray.origin_y);
+    __m256 const idx   = _mm256_set1_ps(ray.inv_dir_x);
+    __m256 const idy   = _mm256_set1_ps(ray.inv_dir_y);
+    __m256 const t_max = _mm256_set1_ps(ray.t_max);
+    __m256 const zero  = _mm256_setzero_ps();
+
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        __m256 bx = _mm256_loadu_ps(boxes.x + i), by = _mm256_loadu_ps(boxes.y + i);
+        __m256 bx1 = _mm256_add_ps(bx, _mm256_loadu_ps(boxes.w + i));
+        __m256 by1 = _mm256_add_ps(by, _mm256_loadu_ps(boxes.h + i));
+        __m256 x0  = _mm256_mul_ps(_mm256_sub_ps(bx, ox), idx);
+        __m256 x1  = _mm256_mul_ps(_mm256_sub_ps(bx1, ox), idx);
+        __m256 y0  = _mm256_mul_ps(_mm256_sub_ps(by, oy), idy);
+        __m256 y1  = _mm256_mul_ps(_mm256_sub_ps(by1, oy), idy);
+
+        __m256 enter = _mm256_max_ps(_mm256_min_ps(x0, x1), _mm256_min_ps(y0, y1));
+        __m256 leave = _mm256_min_ps(_mm256_max_ps(x0, x1), _mm256_max_ps(y0, y1));
+        enter        = _mm256_max_ps(enter, zero);
+        leave        = _mm256_min_ps(leave, t_max);
+        __m256 hit   = _mm256_cmp_ps(enter, leave, _CMP_LE_OQ);
+        Collision_SetHits(hits, i, Cast(uint32, _mm256_movemask_ps(hit)));
+    }
+    for (; i < n; ++i)
+    {
+        Collision_SetHits(hits, i, Collision_RayRow(ray, boxes, i));
+    }
+}
+
+#endif
+
+
+void
+Collision_Overlap(CollisionBoxes const& a, CollisionBoxes const& b, size_t n, uint64* hits)
+{
+#if defined(COLLISION_X86)
+    static bool const has_avx2 = Platform_CpuHasAvx2();
+    if (has_avx2)
+    {
+        Collision_OverlapAvx2(a, b, n, hits);
+    }
+    else
+    {
+        Collision_OverlapSse2(a, b, n, hits);
+    }
+#else
+    Collision_OverlapScalar(a, b, n, hits);
+#endif
+}
+
+
+void
+Collision_PointInBox(float const*          px,
+                     float const*          py,
+                     CollisionBoxes const& boxes,
+                     size_t                n,
+                     uint64*               hits)
+{
+#if defined(COLLISION_X86)
+    static bool const has_avx2 = Platform_CpuHasAvx2();
+    if (has_avx2)
+    {
+        Collision_PointInBoxAvx2(px, py, boxes, n, hits);
+    }
+    else
+    {
+        Collision_PointInBoxSse2(px, py, boxes, n, hits);
+    }
+#else
+    Collision_PointInBoxScalar(px, py, boxes, n, hits);
+#endif
+}
+
+
+void
+Collision_Ray(CollisionRay const& ray, CollisionBoxes const& boxes, size_t n, uint64* hits)
+{
+#if defined(COLLISION_X86)
+    static bool const has_avx2 = Platform_CpuHasAvx2();
+    if (has_avx2)
+    {
+        Collision_RayAvx2(ray, boxes, n, hits);
+    }
+    else
+    {
+        Collision_RaySse2(ray, boxes, n, hits);
+    }
+#else
+    Collision_RayScalar(ray, boxes, n, hits);
+#endif
+}
@@ -0,0 +1,128 @@
+#pragma once
+
+#include "Base/dllexports.h"
+#include "Base/typedefs.h"
+#include <cstddef>
+
+
+/// CollisionBoxes - n axis aligned boxes as a corner and a size, one array per
+/// field, the way BoundingBoxComponent stores them once its offset is added
+/// to the position. A box holds x <= px < x + w and y <= py < y + h.
+struct CollisionBoxes
+{
+    float const* x;
+    float const* y;
+    float const* w;
+    float const* h;
+};
+
+/// CollisionRay - origin + t * direction for 0 <= t <= t_max. The direction is
+/// given as its reciprocal, 1 / dx and 1 / dy, which may be infinite.
+///
+/// NOTE: A ray along an axis that starts exactly on a box's edge may miss it.
+struct CollisionRay
+{
+    float origin_x, origin_y;
+    float inv_dir_x, inv_dir_y;
+    float t_max;
+};
+
+
+/// Collision_HitWords - how many uint64 a hit mask for n tests needs.
+constexpr size_t
+Collision_HitWords(size_t n)
+{
+    return (n + 63) / 64;
+}
+
+/// Collision_IsHit - whether test i hit, from a hit mask.
+inline bool
+Collision_IsHit(uint64 const* hits, size_t i)
+{
+    return (hits[i / 64] >> (i % 64)) & 1;
+}
+
+
+// Every kernel writes bit i of hits, Collision_HitWords(n) words, for test i
+// and zeroes the bits past n. The SIMD kernels give the same hits as the
+// scalar ones, they only compare, add, subtract and multiply.
+
+/// CollisionOverlapKernel - whether box i of a overlaps box i of b, touching doesn't count.
+using CollisionOverlapKernel = void (*)(CollisionBoxes const& a,
+                                        CollisionBoxes const& b,
+                                        size_t                n,
+                                        uint64*               hits);
+
+/// CollisionPointKernel - whether point i, px[i], py[i], is inside box i.
+using CollisionPointKernel = void (*)(float const*          px,
+                                      float const*          py,
+                                      CollisionBoxes const& boxes,
+                                      size_t                n,
+                                      uint64*               hits);
+
+/// CollisionRayKernel - whether the ray hits box i, the slab test.
+using CollisionRayKernel = void (*)(CollisionRay const&   ray,
+                                    CollisionBoxes const& boxes,
+                                    size_t                n,
+                                    uint64*               hits);
+
+
+public_func void
+Collision_OverlapScalar(CollisionBoxes const& a, CollisionBoxes const& b, size_t n, uint64* hits);
+
+public_func void
+Collision_PointInBoxScalar(float const*          px,
+                           float const*          py,
+                           CollisionBoxes const& boxes,
+                           size_t                n,
+                           uint64*               hits);
+
+public_func void
+Collision_RayScalar(CollisionRay const& ray, CollisionBoxes const& boxes, size_t n, uint64* hits);
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64)
+/// 4 tests per instruction.
+public_func void
+Collision_OverlapSse2(CollisionBoxes const& a, CollisionBoxes const& b, size_t n, uint64* hits);
+
+public_func void
+Collision_PointInBoxSse2(float const*          px,
+                         float const*          py,
+                         CollisionBoxes const& boxes,
+                         size_t                n,
+                         uint64*               hits);
+
+public_func void
+Collision_RaySse2(CollisionRay const& ray, CollisionBoxes const& boxes, size_t n, uint64* hits);
+
+/// 8 tests per instruction.
+public_func void
+Collision_OverlapAvx2(CollisionBoxes const& a, CollisionBoxes const& b, size_t n, uint64* hits);
+
+public_func void
+Collision_PointInBoxAvx2(float const*          px,
+                         float const*          py,
+                         CollisionBoxes const& boxes,
+                         size_t                n,
+                         uint64*               hits);
+
+public_func void
+Collision_RayAvx2(CollisionRay const& ray, CollisionBoxes const& boxes, size_t n, uint64* hits);
+#endif
+
+
+/// Collision_Overlap - the best overlap kernel on this cpu, checked at runtime.
+public_func void
+Collision_Overlap(CollisionBoxes const& a, CollisionBoxes const& b, size_t n, uint64* hits);
+
+/// Collision_PointInBox - the best point in box kernel on this cpu, checked at runtime.
+public_func void
+Collision_PointInBox(float const*          px,
+                     float const*          py,
+                     CollisionBoxes const& boxes,
+                     size_t                n,
+                     uint64*               hits);
+
+/// Collision_Ray - the best ray kernel on this cpu, checked at runtime.
+public_func void
+Collision_Ray(CollisionRay const& ray, CollisionBoxes const& boxes, size_t n, uint64* hits);
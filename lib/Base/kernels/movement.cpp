@@ -0,0 +1,217 @@
+#include "Base/kernels/movement.h"
+#include "Base/platform/platform.h"
+#include <algorithm>
+#include <cmath>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64)
+#define MOVEMENT_X86 1
+#include <immintrin.h>
+#endif
+
+// Deterministic mode needs every multiply and add of the scalar and SSE2
+// kernels rounded on its own, so contracting them into fused multiply adds is
+// turned off for this file, whatever flags it is built with. MSVC doesn't
+// contract under its default /fp:precise.
+#if defined(__clang__)
+#pragma STDC FP_CONTRACT OFF
+#elif defined(__GNUC__)
+#pragma GCC optimize("fp-contract=off")
+#endif
+
+// MSVC lets any function use any instruction set, GCC and Clang need telling.
+#if defined(MOVEMENT_X86) && !defined(_MSC_VER)
+#define MOVEMENT_TARGET(isa) __attribute__((target(isa)))
+#else
+#define MOVEMENT_TARGET(isa)
+#endif
+
+
+MovementParams
+Movement_ParamsForSteps(MovementParams const& params, uint32 steps)
+{
+    if (steps <= 1)
+    {
+        return params;
+    }
+
+    // NOTE: The kernels only take friction off speeds above stop_speed, and
+    // zero the rest, so raising it to the friction clamps the speed at zero.
+    MovementParams result = params;
+    result.friction       = params.friction * Cast(float, steps);
+    result.stop_speed     = std::max(params.stop_speed, result.friction);
+    result.dt             = params.dt * Cast(float, steps);
+    return result;
+}
+
+
+void
+Movement_IntegrateScalar(float*                positions,
+                         float*                velocities,
+                         size_t                n,
+                         MovementParams const& params)
+{
+    for (size_t i = 0; i < n; ++i)
+    {
+        float* p = positions + (i * 2);
+        float* v = velocities + (i * 2);
+
+        float speed = std::sqrt((v[0] * v[0]) + (v[1] * v[1]));
+        if (speed > params.stop_speed)
+        {
+            v[0] = v[0] - ((v[0] / speed) * params.friction);
+            v[1] = v[1] - ((v[1] / speed) * params.friction);
+        }
+        else
+        {
+            v[0] = 0.0f;
+            v[1] = 0.0f;
+        }
+
+        p[0] = p[0] + ((params.scale * v[0]) * params.dt);
+        p[1] = p[1] + ((params.scale * v[1]) * params.dt);
+    }
+}
+
+
+#if defined(MOVEMENT_X86)
+
+// The SIMD kernels work on the interleaved pairs as they are, x and y of an
+// entity sit in neighbouring lanes. Squaring, then adding each lane to its
+// neighbour, leaves vx * vx + vy * vy in both lanes of the entity, which is
+// the same sum the scalar kernel makes since addition is commutative. Every
+// other step is the same operation in the same order as the scalar kernel.
+
+void
+Movement_IntegrateSse2(float* positions, float* velocities, size_t n, MovementParams const& params)
+{
+    __m128 const friction   = _mm_set1_ps(params.friction);
+    __m128 const stop_speed = _mm_set1_ps(params.stop_speed);
+    __m128 const scale      = _mm_set1_ps(params.scale);
+    __m128 const dt         = _mm_set1_ps(params.dt);
+
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2)
+    {
+        __m128 v = _mm_loadu_ps(velocities + (i * 2));
+        __m128 p = _mm_loadu_ps(positions + (i * 2));
+
+        __m128 squared = _mm_mul_ps(v, v);
+        __m128 swapped = _mm_shuffle_ps(squared, squared, _MM_SHUFFLE(2, 3, 0, 1));
+        __m128 speed   = _mm_sqrt_ps(_mm_add_ps(squared, swapped));
+        __m128 moving  = _mm_cmpgt_ps(speed, stop_speed);
+
+        v = _mm_sub_ps(v, _mm_mul_ps(_mm_div_ps(v, speed), friction));
+        v = _mm_and_ps(v, moving);
+        p = _mm_add_ps(p, _mm_mul_ps(_mm_mul_ps(scale, v), dt));
+
+        _mm_storeu_ps(velocities + (i * 2), v);
+        _mm_storeu_ps(positions + (i * 2), p);
+    }
+
+    Movement_IntegrateScalar(positions + (i * 2), velocities + (i * 2), n - i, params);
+}
+
+
+// NOTE: Built for AVX2 alone, without FMA, so the compiler can't fuse the
+// multiplies and adds and change the rounding.
+MOVEMENT_TARGET("avx2") void
+Movement_IntegrateAvx2(float* positions, float* velocities, size_t n, MovementParams const& params)
+{
+    __m256 const friction   = _mm256_set1_ps(params.friction);
+    __m256 const stop_speed = _mm256_set1_ps(params.stop_speed);
+    __m256 const scale      = _mm256_set1_ps(params.scale);
+    __m256 const dt         = _mm256_set1_ps(params.dt);
+
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        __m256 v = _mm256_loadu_ps(velocities + (i * 2));
+        __m256 p = _mm256_loadu_ps(positions + (i * 2));
+
+        __m256 squared = _mm256_mul_ps(v, v);
+        __m256 swapped = _mm256_permute_ps(squared, _MM_SHUFFLE(2, 3, 0, 1));
+        __m256 speed   = _mm256_sqrt_ps(_mm256_add_ps(squared, swapped));
+        __m256 moving  = _mm256_cmp_ps(speed, stop_speed, _CMP_GT_OQ);
+
+        v = _mm256_sub_ps(v, _mm256_mul_ps(_mm256_div_ps(v, speed), friction));
+        v = _mm256_and_ps(v, moving);
+        p = _mm256_add_ps(p, _mm256_mul_ps(_mm256_mul_ps(scale, v), dt));
+
+        _mm256_storeu_ps(velocities + (i * 2), v);
+        _mm256_storeu_ps(positions + (i * 2), p);
+    }
+
+    Movement_IntegrateSse2(positions + (i * 2), velocities + (i * 2), n - i, params);
+}
+
+
+// Swaps the square root and divide for a reciprocal square root estimate with
+// one Newton-Raphson step, about 22 bits, and fuses the multiplies and adds.
+MOVEMENT_TARGET("avx2,fma") void
+Movement_IntegrateAvx2Fast(float*                positions,
+                           float*                velocities,
+                           size_t                n,
+                           MovementParams const& params)
+{
+    __m256 const friction = _mm256_set1_ps(params.friction);
+    __m256 const stop_sq  = _mm256_set1_ps(params.stop_speed * params.stop_speed);
+    __m256 const step     = _mm256_set1_ps(params.scale * params.dt);
+    __m256 const half     = _mm256_set1_ps(0.5f);
+    __m256 const three    = _mm256_set1_ps(3.0f);
+
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        __m256 v = _mm256_loadu_ps(velocities + (i * 2));
+        __m256 p = _mm256_loadu_ps(positions + (i * 2));
+
+        __m256 squared    = _mm256_mul_ps(v, v);
+        __m256 swapped    = _mm256_permute_ps(squared, _MM_SHUFFLE(2, 3, 0, 1));
+        __m256 speed_sq   = _mm256_add_ps(squared, swapped);
+        __m256 moving     = _mm256_cmp_ps(speed_sq, stop_sq, _CMP_GT_OQ);
+        __m256 inv_speed  = _mm256_rsqrt_ps(speed_sq);
+        __m256 inv_sq_err = _mm256_fnmadd_ps(_mm256_mul_ps(speed_sq, inv_speed), inv_speed, three);
+        inv_speed         = _mm256_mul_ps(_mm256_mul_ps(half, inv_speed), inv_sq_err);
+
+        v = _mm256_fnmadd_ps(_mm256_mul_ps(v, inv_speed), friction, v);
+        v = _mm256_and_ps(v, moving);
+        p = _mm256_fmadd_ps(v, step, p);
+
+        _mm256_storeu_ps(velocities + (i * 2), v);
+        _mm256_storeu_ps(positions + (i * 2), p);
+    }
+
+    Movement_IntegrateScalar(positions + (i * 2), velocities + (i * 2), n - i, params);
+}
+
+#endif
+
+
+MovementKernel
+Movement_SelectKernel(MovementMode mode)
+{
+#if defined(MOVEMENT_X86)
+    static bool const has_avx2 = Platform_CpuHasAvx2();
+    static bool const has_fma  = Platform_CpuHasFma();
+
+    if (mode == MovementMode::Fast && has_avx2 && has_fma)
+    {
+        return Movement_IntegrateAvx2Fast;
+    }
+    return has_avx2 ? Movement_IntegrateAvx2 : Movement_IntegrateSse2;
+#else
+    (void)mode;
+    return Movement_IntegrateScalar;
+#endif
+}
+
+
+void
+Movement_Integrate(float*                positions,
+                   float*                velocities,
+                   size_t                n,
+                   MovementParams const& params,
+                   MovementMode          mode)
+{
+    Movement_SelectKernel(mode)(positions, velocities, n, params);
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include "Base/dllexports.h"
+#include "Base/typedefs.h"
+#include <cstddef>
+
+
+/// MovementMode - how Movement_Integrate may compute its results.
+///
+/// Deterministic gives bit for bit the same results as Movement_IntegrateScalar
+/// whichever instruction set is picked, so a simulation can be replayed or
+/// compared across machines. Fast uses a reciprocal square root estimate and
+/// fused multiply adds, so results differ in the last few bits.
+///
+/// NOTE: movement.cpp turns off contraction into fused multiply adds, so the
+/// scalar kernel rounds the same way when the compiler is allowed to use FMA.
+enum class MovementMode
+{
+    Deterministic,
+    Fast,
+};
+
+
+struct MovementParams
+{
+    float friction;   // Speed lost per step, against the direction of travel.
+    float stop_speed; // At or below this speed the velocity snaps to zero.
+    float scale;      // Distance moved per second at a speed of 1.
+    float dt;
+};
+
+
+/// MovementKernel - positions and velocities hold n interleaved x, y pairs.
+using MovementKernel = void (*)(float*                positions,
+                                float*                velocities,
+                                size_t                n,
+                                MovementParams const& params);
+
+
+/// Movement_ParamsForSteps - params that cover steps steps of params in one call.
+///
+/// Friction takes the same amount off the speed every step, so it takes that
+/// much off for each step at once. A speed that would be taken past zero stops
+/// instead, where the steps one at a time leave it, rather than reversing. For
+/// a single step the params are returned as they are.
+public_func MovementParams
+Movement_ParamsForSteps(MovementParams const& params, uint32 steps);
+
+
+/// Movement_IntegrateScalar - the reference kernel, one entity at a time.
+///
+///     speed = sqrt(vx * vx + vy * vy)
+///     v     = speed > stop_speed ? v - (v / speed) * friction : 0
+///     p     = p + (scale * v) * dt
+public_func void
+Movement_IntegrateScalar(float*                positions,
+                         float*                velocities,
+                         size_t                n,
+                         MovementParams const& params);
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64)
+/// Movement_IntegrateSse2 - 2 entities per instruction, deterministic.
+public_func void
+Movement_IntegrateSse2(float* positions, float* velocities, size_t n, MovementParams const& params);
+
+/// Movement_IntegrateAvx2 - 4 entities per instruction, deterministic.
+public_func void
+Movement_IntegrateAvx2(float* positions, float* velocities, size_t n, MovementParams const& params);
+
+/// Movement_IntegrateAvx2Fast - 4 entities per instruction, needs FMA as well as AVX2.
+public_func void
+Movement_IntegrateAvx2Fast(float*                positions,
+                           float*                velocities,
+                           size_t                n,
+                           MovementParams const& params);
+#endif
+
+/// Movement_SelectKernel - the best kernel for mode on this cpu, checked at runtime.
+public_func MovementKernel
+Movement_SelectKernel(MovementMode mode);
+
+/// Movement_Integrate - applies friction to each velocity and then moves each position by it.
+public_func void
+Movement_Integrate(float*                positions,
+                   float*                velocities,
+                   size_t                n,
+                   MovementParams const& params,
+                   MovementMode          mode = MovementMode::Deterministic);
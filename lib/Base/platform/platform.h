@@ -33,6 +33,55 @@ Platform_FreeVirtualMemory(void* addr, uint64 size)
 }
 
 
+/// Platform_ReserveVirtualMemory - reserves address space without backing it with memory.
+/// Pages must be committed with Platform_CommitVirtualMemory before they are used, and the
+/// whole range is released with Platform_FreeVirtualMemory.
+inline void*
+Platform_ReserveVirtualMemory(uint64 size, uint64 start_addr = 0)
+{
+#if defined(_MSC_VER)
+    return Windows_ReserveVirtualMemory(size, start_addr);
+#else
+    return Linux_ReserveVirtualMemory(size, start_addr);
+#endif
+}
+
+
+inline bool
+Platform_CommitVirtualMemory(void* addr, uint64 size)
+{
+#if defined(_MSC_VER)
+    return Windows_CommitVirtualMemory(addr, size);
+#else
+    return Linux_CommitVirtualMemory(addr, size);
+#endif
+}
+
+
+/// Platform_CpuHasAvx2 - checked at runtime, so code built for the baseline
+/// instruction set can still pick AVX2 kernels on machines that have it.
+inline bool
+Platform_CpuHasAvx2()
+{
+#if defined(_MSC_VER)
+    return Windows_CpuHasAvx2();
+#else
+    return Linux_CpuHasAvx2();
+#endif
+}
+
+
+inline bool
+Platform_CpuHasFma()
+{
+#if defined(_MSC_VER)
+    return Windows_CpuHasFma();
+#else
+    return Linux_CpuHasFma();
+#endif
+}
+
+
 inline uint64
 Platform_GetPerformanceCounter()
 {
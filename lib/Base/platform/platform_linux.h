@@ -24,4 +24,49 @@ inline void
 Linux_FreeVirtualMemory(void* addr, uint64 size)
 {
     munmap(addr, size);
-}
\ No newline at end of file
+}
+
+
+inline void*
+Linux_ReserveVirtualMemory(uint64 size, uint64 start_addr = 0)
+{
+    auto* region = mmap((void*)start_addr,
+                        size,
+                        PROT_NONE,
+                        MAP_PRIVATE | MAP_ANON | MAP_NORESERVE,
+                        -1,
+                        0);
+
+    assert(region != MAP_FAILED);
+    return region;
+}
+
+
+inline bool
+Linux_CommitVirtualMemory(void* addr, uint64 size)
+{
+    return mprotect(addr, size, PROT_READ | PROT_WRITE) == 0;
+}
+
+
+/// Linux_CpuHasAvx2 - true if the cpu, and the os, support AVX2.
+inline bool
+Linux_CpuHasAvx2()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __builtin_cpu_supports("avx2");
+#else
+    return false;
+#endif
+}
+
+
+inline bool
+Linux_CpuHasFma()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __builtin_cpu_supports("fma");
+#else
+    return false;
+#endif
+}
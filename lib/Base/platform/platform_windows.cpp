@@ -3,6 +3,7 @@
 #include <windows.h>
 
 #include <cassert>
+#include <intrin.h>
 #include <memoryapi.h>
 
 
@@ -26,4 +27,60 @@ Windows_FreeVirtualMemory(void* addr, uint64 size)
                               size,
                               MEM_RELEASE);
     assert(result == 0);
-}
\ No newline at end of file
+}
+
+
+void*
+Windows_ReserveVirtualMemory(uint64 size, uint64 start_addr)
+{
+    auto* region = VirtualAlloc((void*)start_addr,
+                                size,
+                                MEM_RESERVE,     // allocation type
+                                PAGE_NOACCESS); // protect
+
+    assert(region);
+    return region;
+}
+
+
+bool
+Windows_CommitVirtualMemory(void* addr, uint64 size)
+{
+    auto* region = VirtualAlloc(addr,
+                                size,
+                                MEM_COMMIT,      // allocation type
+                                PAGE_READWRITE); // protect
+
+    return region != nullptr;
+}
+
+
+// NOTE: AVX state has to be enabled by the os as well as supported by the cpu.
+static bool
+Windows_OsSavesAvxState()
+{
+    int info[4];
+    __cpuid(info, 1);
+
+    bool osxsave = (info[2] & (1 << 27)) != 0;
+    bool avx     = (info[2] & (1 << 28)) != 0;
+    return osxsave && avx && ((_xgetbv(0) & 0x6) == 0x6);
+}
+
+
+bool
+Windows_CpuHasAvx2()
+{
+    int info[4];
+    __cpuidex(info, 7, 0);
+    return Windows_OsSavesAvxState() && (info[1] & (1 << 5)) != 0;
+}
+
+
+bool
+Windows_CpuHasFma()
+{
+    int info[4];
+    __cpuid(info, 1);
+    return Windows_OsSavesAvxState() && (info[2] & (1 << 12)) != 0;
+}
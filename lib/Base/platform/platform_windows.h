@@ -9,4 +9,20 @@ Windows_AllocateVirtualMemory(uint64 size, uint64 start_addr = 0);
 
 
 public_func void
-Windows_FreeVirtualMemory(void* addr, uint64 size);
\ No newline at end of file
+Windows_FreeVirtualMemory(void* addr, uint64 size);
+
+
+public_func void*
+Windows_ReserveVirtualMemory(uint64 size, uint64 start_addr = 0);
+
+
+public_func bool
+Windows_CommitVirtualMemory(void* addr, uint64 size);
+
+
+public_func bool
+Windows_CpuHasAvx2();
+
+
+public_func bool
+Windows_CpuHasFma();
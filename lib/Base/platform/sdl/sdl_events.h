@@ -1,5 +1,6 @@
 #pragma once
 #include "Base/containers/array.h"
+#include "Base/containers/bitset.h"
 #include "Base/typedefs.h"
 #include <SDL2/SDL.h>
 
@@ -87,7 +88,7 @@ struct SDL_EventKeyFilter
 {
     SDL_EventKeyCallback                 _callback;
     void*                                _userdata;
-    Array<SDL_Scancode, 64>              _key_filter;
+    BitSet<SDL_NUM_SCANCODES>            _key_filter;
     Array<SDL_Event, SDL_EVENTQUEUESIZE> _current_events;
 };
 
@@ -100,12 +101,9 @@ SDL_EventKeyFilterCheckEvent(SDL_EventKeyFilter&                   filter,
 
     for (auto& event : keyboard_events)
     {
-        for (auto& code : filter._key_filter)
+        if (filter._key_filter.test(event.key.keysym.scancode))
         {
-            if (event.key.keysym.scancode == code)
-            {
-                filter._current_events.push_back(event);
-            }
+            filter._current_events.push_back(event);
         }
     }
 
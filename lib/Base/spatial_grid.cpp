@@ -0,0 +1,254 @@
+#include "Base/spatial_grid.h"
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cmath>
+
+
+static inline uint32
+SpatialGrid_Bucket(SpatialGrid const& grid, int32 x, int32 y)
+{
+    uint32 h = (Cast(uint32, x) * 0x9E3779B1u) ^ (Cast(uint32, y) * 0x85EBCA77u);
+    return (h ^ (h >> 15)) & grid.bucket_mask;
+}
+
+
+void
+SpatialGrid_Init(SpatialGrid& grid, float cell_size, uint32 bucket_count)
+{
+    assert(cell_size > 0.0f);
+
+    grid.cell_size     = cell_size;
+    grid.inv_cell_size = 1.0f / cell_size;
+    grid.buckets.clear();
+    grid.buckets.resize(std::bit_ceil(std::max(bucket_count, 1u)));
+    grid.bucket_mask = Cast(uint32, grid.buckets.size() - 1);
+
+    grid.boxes.clear();
+    grid.cells.clear();
+    grid.slots.clear();
+    grid.stamps.clear();
+    grid.ids.clear();
+    grid.stamp = 0;
+}
+
+
+void
+SpatialGrid_Clear(SpatialGrid& grid)
+{
+    for (auto& bucket : grid.buckets)
+    {
+        bucket.clear();
+    }
+    for (uint32 id : grid.ids)
+    {
+        grid.slots[id] = SPATIAL_GRID_ABSENT;
+    }
+    grid.ids.clear();
+}
+
+
+static inline int32
+SpatialGrid_Cell(SpatialGrid const& grid, float v)
+{
+    return Cast(int32, std::floor(v * grid.inv_cell_size));
+}
+
+
+SpatialCells
+SpatialGrid_CellsOf(SpatialGrid const& grid, SpatialBox const& box)
+{
+    // NOTE: max is exclusive, but a box ending exactly on a cell edge still
+    // takes that cell, which costs a little work and never misses an overlap.
+    return { SpatialGrid_Cell(grid, box.min_x),
+             SpatialGrid_Cell(grid, box.min_y),
+             SpatialGrid_Cell(grid, box.max_x),
+             SpatialGrid_Cell(grid, box.max_y) };
+}
+
+
+static void
+SpatialGrid_Insert(SpatialGrid& grid, uint32 id, SpatialCells const& cells)
+{
+    for (int32 y = cells.y0; y <= cells.y1; ++y)
+    {
+        for (int32 x = cells.x0; x <= cells.x1; ++x)
+        {
+            auto& bucket = grid.buckets[SpatialGrid_Bucket(grid, x, y)];
+            if (std::find(bucket.begin(), bucket.end(), id) == bucket.end())
+            {
+                bucket.push_back(id);
+            }
+        }
+    }
+}
+
+
+static void
+SpatialGrid_Erase(SpatialGrid& grid, uint32 id, SpatialCells const& cells)
+{
+    for (int32 y = cells.y0; y <= cells.y1; ++y)
+    {
+        for (int32 x = cells.x0; x <= cells.x1; ++x)
+        {
+            auto& bucket = grid.buckets[SpatialGrid_Bucket(grid, x, y)];
+            auto  it     = std::find(bucket.begin(), bucket.end(), id);
+            if (it != bucket.end())
+            {
+                *it = bucket.back();
+                bucket.pop_back();
+            }
+        }
+    }
+}
+
+
+void
+SpatialGrid_Update(SpatialGrid& grid, uint32 id, SpatialBox const& box)
+{
+    assert(grid.bucket_mask + 1 == grid.buckets.size() && "SpatialGrid_Init first");
+
+    if (id >= grid.slots.size())
+    {
+        grid.boxes.resize(id + 1);
+        grid.cells.resize(id + 1);
+        grid.slots.resize(id + 1, SPATIAL_GRID_ABSENT);
+        grid.stamps.resize(id + 1, 0);
+    }
+
+    SpatialCells cells = SpatialGrid_CellsOf(grid, box);
+    if (grid.slots[id] == SPATIAL_GRID_ABSENT)
+    {
+        grid.slots[id] = Cast(uint32, grid.ids.size());
+        grid.ids.push_back(id);
+        SpatialGrid_Insert(grid, id, cells);
+    }
+    else if (!(grid.cells[id] == cells))
+    {
+        SpatialGrid_Erase(grid, id, grid.cells[id]);
+        SpatialGrid_Insert(grid, id, cells);
+    }
+
+    grid.boxes[id] = box;
+    grid.cells[id] = cells;
+}
+
+
+void
+SpatialGrid_Remove(SpatialGrid& grid, uint32 id)
+{
+    if (!SpatialGrid_Contains(grid, id))
+    {
+        return;
+    }
+
+    SpatialGrid_Erase(grid, id, grid.cells[id]);
+
+    uint32 slot       = grid.slots[id];
+    uint32 moved      = grid.ids.back();
+    grid.ids[slot]    = moved;
+    grid.slots[moved] = slot;
+    grid.slots[id]    = SPATIAL_GRID_ABSENT;
+    grid.ids.pop_back();
+}
+
+
+bool
+SpatialGrid_Contains(SpatialGrid const& grid, uint32 id)
+{
+    return id < grid.slots.size() && grid.slots[id] != SPATIAL_GRID_ABSENT;
+}
+
+
+size_t
+SpatialGrid_Query(SpatialGrid& grid, SpatialBox const& box, std::vector<uint32>& out)
+{
+    grid.stamp += 1;
+    if (grid.stamp == 0)
+    {
+        std::fill(grid.stamps.begin(), grid.stamps.end(), 0);
+        grid.stamp = 1;
+    }
+
+    size_t       first = out.size();
+    SpatialCells cells = SpatialGrid_CellsOf(grid, box);
+    for (int32 y = cells.y0; y <= cells.y1; ++y)
+    {
+        for (int32 x = cells.x0; x <= cells.x1; ++x)
+        {
+            for (uint32 id : grid.buckets[SpatialGrid_Bucket(grid, x, y)])
+            {
+                if (grid.stamps[id] != grid.stamp)
+                {
+                    grid.stamps[id] = grid.stamp;
+                    if (SpatialBox_Overlaps(grid.boxes[id], box))
+                    {
+                        out.push_back(id);
+                    }
+                }
+            }
+        }
+    }
+    return out.size() - first;
+}
+
+
+size_t
+SpatialGrid_Pairs(SpatialGrid const& grid, std::vector<SpatialPair>& out)
+{
+    size_t first = out.size();
+    for (uint32 a : grid.ids)
+    {
+        SpatialBox const&   box   = grid.boxes[a];
+        SpatialCells const& cells = grid.cells[a];
+        for (int32 y = cells.y0; y <= cells.y1; ++y)
+        {
+            for (int32 x = cells.x0; x <= cells.x1; ++x)
+            {
+                for (uint32 b : grid.buckets[SpatialGrid_Bucket(grid, x, y)])
+                {
+                    if (b <= a || !SpatialBox_Overlaps(box, grid.boxes[b]))
+                    {
+                        continue;
+                    }
+
+                    SpatialBox const& other = grid.boxes[b];
+                    if (SpatialGrid_Cell(grid, std::max(box.min_x, other.min_x)) == x
+                        && SpatialGrid_Cell(grid, std::max(box.min_y, other.min_y)) == y)
+                    {
+                        out.push_back({ a, b });
+                    }
+                }
+            }
+        }
+    }
+    return out.size() - first;
+}
+
+
+size_t
+SpatialGrid_Candidates(SpatialGrid const& grid, std::vector<SpatialPair>& out)
+{
+    size_t first = out.size();
+    for (uint32 a : grid.ids)
+    {
+        SpatialCells const& cells = grid.cells[a];
+        for (int32 y = cells.y0; y <= cells.y1; ++y)
+        {
+            for (int32 x = cells.x0; x <= cells.x1; ++x)
+            {
+                for (uint32 b : grid.buckets[SpatialGrid_Bucket(grid, x, y)])
+                {
+                    // Only from the first cell both cover, b may just share the bucket.
+                    SpatialCells const& other = grid.cells[b];
+                    if (b > a && std::max(cells.x0, other.x0) == x
+                        && std::max(cells.y0, other.y0) == y && other.x1 >= x && other.y1 >= y)
+                    {
+                        out.push_back({ a, b });
+                    }
+                }
+            }
+        }
+    }
+    return out.size() - first;
+}
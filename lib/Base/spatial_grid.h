@@ -0,0 +1,111 @@
+#pragma once
+
+#include "Base/dllexports.h"
+#include "Base/typedefs.h"
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+
+/// SpatialBox - an axis aligned box, min inclusive and max exclusive.
+struct SpatialBox
+{
+    float min_x, min_y;
+    float max_x, max_y;
+};
+
+/// SpatialCells - the cells a box covers, both corners inclusive.
+struct SpatialCells
+{
+    int32 x0, y0;
+    int32 x1, y1;
+
+    bool
+    operator==(SpatialCells const& other) const = default;
+};
+
+using SpatialPair = std::pair<uint32, uint32>;
+
+
+inline bool
+SpatialBox_Overlaps(SpatialBox const& a, SpatialBox const& b)
+{
+    return a.min_x < b.max_x && b.min_x < a.max_x && a.min_y < b.max_y && b.min_y < a.max_y;
+}
+
+
+/// SpatialGrid - a uniform grid over an unbounded plane, hashed into a fixed
+/// number of buckets, for finding which boxes overlap which.
+///
+/// Each item is a caller chosen id, kept in the bucket of every cell its box
+/// covers. Moving a box only touches the buckets when it crosses into another
+/// cell, so updating every moving item each tick costs little more than
+/// writing its box. Cells should be about the size of a typical box, larger
+/// boxes cover many cells and smaller cells cost more buckets per box.
+///
+/// Cells that hash to the same bucket share it, queries skip the items of the
+/// other cells by testing the boxes.
+public_struct SpatialGrid
+{
+    float  cell_size { 1.0f };
+    float  inv_cell_size { 1.0f };
+    uint32 bucket_mask { 0 };
+
+    std::vector<std::vector<uint32>> buckets; // An id appears in a bucket at most once.
+
+    // Indexed by id.
+    std::vector<SpatialBox>   boxes;
+    std::vector<SpatialCells> cells;
+    std::vector<uint32>       slots;  // Where the id is in ids, SPATIAL_GRID_ABSENT if it isn't.
+    std::vector<uint32>       stamps; // The last query to see the id.
+
+    std::vector<uint32> ids; // Every item, in no order.
+    uint32              stamp { 0 };
+};
+
+
+constexpr uint32 SPATIAL_GRID_ABSENT = UINT32_MAX;
+
+
+/// SpatialGrid_Init - empties the grid and sets its cell size and bucket count,
+/// rounded up to a power of 2. About as many buckets as items works well.
+public_func void
+SpatialGrid_Init(SpatialGrid& grid, float cell_size, uint32 bucket_count);
+
+/// SpatialGrid_Clear - removes every item, keeping the storage.
+public_func void
+SpatialGrid_Clear(SpatialGrid& grid);
+
+/// SpatialGrid_Update - adds id with box, or moves it to box if it is there already.
+public_func void
+SpatialGrid_Update(SpatialGrid& grid, uint32 id, SpatialBox const& box);
+
+public_func void
+SpatialGrid_Remove(SpatialGrid& grid, uint32 id);
+
+public_func bool
+SpatialGrid_Contains(SpatialGrid const& grid, uint32 id);
+
+/// SpatialGrid_CellsOf - the cells box covers.
+public_func SpatialCells
+SpatialGrid_CellsOf(SpatialGrid const& grid, SpatialBox const& box);
+
+/// SpatialGrid_Query - appends to out the id of every item overlapping box,
+/// each once, e.g. what is on screen. Returns how many it appended.
+public_func size_t
+SpatialGrid_Query(SpatialGrid& grid, SpatialBox const& box, std::vector<uint32>& out);
+
+/// SpatialGrid_Pairs - appends to out every pair of overlapping items, the
+/// smaller id first and each pair once. Returns how many it appended.
+///
+/// A pair is only reported from the cell holding the min corner of where the
+/// two boxes overlap, which both of them cover, so it needs no memory to skip
+/// the pairs it has seen from other cells.
+public_func size_t
+SpatialGrid_Pairs(SpatialGrid const& grid, std::vector<SpatialPair>& out);
+
+/// SpatialGrid_Candidates - like SpatialGrid_Pairs, but appends every pair of
+/// items that share a cell without testing their boxes, for a narrow phase
+/// that tests them in batches, see Collision_Overlap.
+public_func size_t
+SpatialGrid_Candidates(SpatialGrid const& grid, std::vector<SpatialPair>& out);
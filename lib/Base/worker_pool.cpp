@@ -0,0 +1,135 @@
+#include "Base/worker_pool.h"
+#include <cassert>
+
+
+static thread_local uint32 worker_thread_index = 0;
+
+
+WorkerPool::~WorkerPool()
+{
+    WorkerPool_Shutdown(*this);
+}
+
+
+/// WorkerPool_RunOne - runs the front job, called with the lock held and
+/// returns with it held again.
+static void
+WorkerPool_RunOne(WorkerPool& pool, std::unique_lock<std::mutex>& lock, uint32 thread_index)
+{
+    WorkerJob job = pool.jobs.front();
+    pool.jobs.pop_front();
+
+    lock.unlock();
+    job.run(job.data, thread_index);
+    lock.lock();
+
+    pool.in_flight -= 1;
+    if (pool.in_flight == 0)
+    {
+        pool.signal.notify_all();
+    }
+}
+
+
+static void
+WorkerPool_WorkerMain(WorkerPool* pool, uint32 thread_index)
+{
+    worker_thread_index = thread_index;
+
+    std::unique_lock<std::mutex> lock(pool->mutex);
+    for (;;)
+    {
+        pool->signal.wait(lock, [pool] { return pool->stopping || !pool->jobs.empty(); });
+        if (pool->jobs.empty())
+        {
+            return;
+        }
+        WorkerPool_RunOne(*pool, lock, thread_index);
+    }
+}
+
+
+void
+WorkerPool_Init(WorkerPool& pool, uint32 n_workers)
+{
+    assert(pool.threads.empty());
+
+    pool.stopping = false;
+    pool.threads.reserve(n_workers);
+    for (uint32 i = 0; i < n_workers; ++i)
+    {
+        pool.threads.emplace_back(WorkerPool_WorkerMain, &pool, i + 1);
+    }
+}
+
+
+void
+WorkerPool_Shutdown(WorkerPool& pool)
+{
+    {
+        std::lock_guard<std::mutex> lock(pool.mutex);
+        pool.stopping = true;
+    }
+    pool.signal.notify_all();
+
+    for (auto& thread : pool.threads)
+    {
+        thread.join();
+    }
+    pool.threads.clear();
+
+    // NOTE: With no workers nothing else will run what is left.
+    WorkerPool_Wait(pool);
+}
+
+
+void
+WorkerPool_Push(WorkerPool& pool, WorkerJob job)
+{
+    {
+        std::lock_guard<std::mutex> lock(pool.mutex);
+        pool.jobs.push_back(job);
+        pool.in_flight += 1;
+    }
+    pool.signal.notify_all();
+}
+
+
+void
+WorkerPool_Wait(WorkerPool& pool)
+{
+    std::unique_lock<std::mutex> lock(pool.mutex);
+    while (pool.in_flight > 0)
+    {
+        if (!pool.jobs.empty())
+        {
+            WorkerPool_RunOne(pool, lock, 0);
+        }
+        else
+        {
+            pool.signal.wait(lock);
+        }
+    }
+}
+
+
+uint32
+WorkerPool_ThreadCount(WorkerPool const& pool)
+{
+    return Cast(uint32, pool.threads.size() + 1);
+}
+
+
+uint32
+WorkerPool_ThreadIndex()
+{
+    return worker_thread_index;
+}
+
+
+uint32
+WorkerPool_DefaultWorkerCount()
+{
+    uint32 n = std::thread::hardware_concurrency();
+    return n > 1 ? n - 1 : 0;
+}
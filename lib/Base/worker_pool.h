@@ -0,0 +1,72 @@
+#pragma once
+
+#include "Base/dllexports.h"
+#include "Base/typedefs.h"
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+/// WorkerJobFunction - thread_index is 0 for the thread calling WorkerPool_Wait
+/// and 1 to WorkerPool_ThreadCount() - 1 for the workers, so it can index per
+/// thread data.
+using WorkerJobFunction = void (*)(void* data, uint32 thread_index);
+
+struct WorkerJob
+{
+    WorkerJobFunction run;
+    void*             data;
+};
+
+
+/// WorkerPool - a fixed set of threads running jobs from a shared queue.
+///
+/// Jobs may push more jobs. WorkerPool_Wait runs jobs on the calling thread
+/// until every job pushed, including those pushed by other jobs, is done, so a
+/// pool with no workers runs everything on the calling thread.
+public_struct WorkerPool
+{
+    std::vector<std::thread> threads;
+    std::mutex               mutex;
+    std::condition_variable  signal;
+    std::deque<WorkerJob>    jobs;
+    uint32                   in_flight { 0 }; // Queued or running.
+    bool                     stopping { false };
+
+    WorkerPool()                  = default;
+    WorkerPool(WorkerPool const&) = delete;
+    WorkerPool&
+    operator=(WorkerPool const&) = delete;
+    ~WorkerPool();
+};
+
+
+/// WorkerPool_Init - starts n_workers threads.
+public_func void
+WorkerPool_Init(WorkerPool& pool, uint32 n_workers);
+
+/// WorkerPool_Shutdown - lets queued jobs finish, then joins the workers.
+public_func void
+WorkerPool_Shutdown(WorkerPool& pool);
+
+public_func void
+WorkerPool_Push(WorkerPool& pool, WorkerJob job);
+
+/// WorkerPool_Wait - helps run jobs until none are queued or running.
+public_func void
+WorkerPool_Wait(WorkerPool& pool);
+
+/// WorkerPool_ThreadCount - the workers plus the thread that waits.
+public_func uint32
+WorkerPool_ThreadCount(WorkerPool const& pool);
+
+/// WorkerPool_ThreadIndex - the thread_index jobs on the calling thread are given,
+/// 0 on threads that aren't workers.
+public_func uint32
+WorkerPool_ThreadIndex();
+
+/// WorkerPool_DefaultWorkerCount - one worker per hardware thread, less the one that waits.
+public_func uint32
+WorkerPool_DefaultWorkerCount();
@@ -0,0 +1,151 @@
+#include "Base/kernels/animation.h"
+#include <cassert>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+
+// Odd so the SIMD kernel has a scalar tail.
+constexpr size_t ANIMATION_TEST_COUNT = 1023;
+
+struct AnimationState
+{
+    std::vector<char>  animate; // std::vector<bool> has no data().
+    std::vector<Int>   n_sprites;
+    std::vector<float> frame_t;
+    std::vector<float> anim_t;
+    std::vector<Int>   frame;
+    std::vector<UByte> looped;
+
+    AnimationColumns
+    columns()
+    {
+        static_assert(sizeof(bool) == sizeof(char));
+        return { reinterpret_cast<bool const*>(animate.data()),
+                 n_sprites.data(),
+                 frame_t.data(),
+                 anim_t.data(),
+                 frame.data(),
+                 looped.data(),
+                 animate.size() };
+    }
+};
+
+static AnimationState
+Animation_RandomState()
+{
+    std::mt19937                          rng(4321);
+    std::uniform_int_distribution<Int>    sprites(1, 12);
+    std::uniform_real_distribution<float> seconds(0.01f, 0.2f);
+
+    AnimationState state;
+    for (size_t i = 0; i < ANIMATION_TEST_COUNT; ++i)
+    {
+        Int   n = sprites(rng);
+        float f = seconds(rng);
+        state.animate.push_back(i % 5 != 0);
+        state.n_sprites.push_back(n);
+        state.frame_t.push_back(f);
+        state.anim_t.push_back(f * 0.5f);
+        state.frame.push_back(Cast(Int, i) % n);
+        state.looped.push_back(0);
+    }
+    return state;
+}
+
+static bool
+Animation_Equal(AnimationState const& a, AnimationState const& b)
+{
+    return std::memcmp(a.anim_t.data(), b.anim_t.data(), a.anim_t.size() * sizeof(float)) == 0
+           && a.frame == b.frame && a.looped == b.looped;
+}
+
+static void
+Animation_CountLooped(void* context, uint32 row, uint32 laps)
+{
+    auto& rows = *Cast(std::vector<uint32>*, context);
+    rows.push_back(row);
+    rows.push_back(laps);
+}
+
+void
+Test_Animation()
+{
+    // Against stepping a frame at a time, with times that add up exactly.
+    {
+        float  frame_t = 0.125f;
+        Int    n       = 6;
+        float  anim_t  = 0.0f;
+        Int    frame   = 0;
+        bool   on      = true;
+        UByte  looped  = 0;
+        float  t       = 0.0f;
+        Int    f       = 0;
+        size_t wraps   = 0;
+
+        AnimationColumns columns { &on, &n, &frame_t, &anim_t, &frame, &looped, 1 };
+        for (int step = 0; step < 200; ++step)
+        {
+            float dt = (step % 7) / 32.0f;
+            Animation_Advance(columns, dt);
+
+            t += dt;
+            while (t >= frame_t)
+            {
+                t -= frame_t;
+                f += 1;
+                if (f >= n)
+                {
+                    f = 0;
+                    wraps += 1;
+                }
+            }
+            assert(anim_t == t && frame == f);
+            wraps -= looped;
+        }
+        assert(wraps == 0);
+    }
+
+    // Every kernel gives the scalar kernel's results, whole seconds at a time too.
+    float const steps[] = { 1.0f / 60.0f, 0.05f, 0.0f, 1.0f, 3.7f };
+
+    AnimationState expected = Animation_RandomState();
+    for (float dt : steps)
+    {
+        Animation_AdvanceScalar(expected.columns(), dt);
+    }
+    for (size_t i = 0; i < ANIMATION_TEST_COUNT; ++i)
+    {
+        assert(expected.animate[i] || (expected.frame[i] == 0 && expected.anim_t[i] == 0.0f));
+        assert(expected.frame[i] >= 0 && expected.frame[i] < expected.n_sprites[i]);
+        assert(expected.anim_t[i] >= 0.0f && expected.anim_t[i] < expected.frame_t[i]);
+    }
+
+    AnimationState state = Animation_RandomState();
+    for (float dt : steps)
+    {
+        Animation_Advance(state.columns(), dt);
+    }
+    assert(Animation_Equal(state, expected));
+
+    // A 3.7 second step wraps every animating row at least once.
+    std::vector<uint32> rows;
+    size_t n_looped = Animation_DispatchLooped(state.looped.data(),
+                                               state.looped.size(),
+                                               Animation_CountLooped,
+                                               &rows);
+    assert(n_looped * 2 == rows.size());
+    assert(n_looped == ANIMATION_TEST_COUNT - (ANIMATION_TEST_COUNT + 4) / 5);
+    for (size_t i = 0; i < rows.size(); i += 2)
+    {
+        assert(state.animate[rows[i]] && rows[i + 1] == state.looped[rows[i]]);
+        assert(i == 0 || rows[i - 2] < rows[i]);
+    }
+
+    // No time passing wraps none.
+    Animation_Advance(state.columns(), 0.0f);
+    n_looped = Animation_DispatchLooped(state.looped.data(), state.looped.size(), nullptr, nullptr);
+    assert(n_looped == 0);
+
+    printf("TEST ANIMATION complete.\n");
+}
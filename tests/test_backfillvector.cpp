@@ -1,6 +1,9 @@
+#include "Base/arena.h"
 #include "Base/containers/backfill_vector.hpp"
+#include <array>
 #include <cassert>
 #include <exception>
+#include <stdexcept>
 
 
 auto
@@ -234,6 +237,167 @@ test_remove_empty()
     assert(bfv.size() == 5);
 }
 
+void
+test_remove_span_of_indices()
+{
+    auto                       bfv = make_bfv_12345();
+    std::array<std::size_t, 4> idx { 3, 7, 1, 3 };
+    bfv.remove(std::span<std::size_t>(idx));
+    assert(bfv.at(0) == 1);
+    assert(bfv.at(1) == 5);
+    assert(bfv.at(2) == 3);
+    assert(bfv.size() == 3);
+}
+
+void
+test_remove_span_of_every_index()
+{
+    auto                       bfv = make_bfv_12345();
+    std::array<std::size_t, 5> idx { 4, 0, 2, 1, 3 };
+    bfv.remove(std::span<std::size_t>(idx));
+    assert(bfv.size() == 0);
+}
+
+void
+test_remove_mask_matches_remove_indices()
+{
+    auto      bfv = make_bfv_12345();
+    BitSet<5> mask;
+    mask.set(1);
+    mask.set(3);
+    bfv.remove(mask);
+    assert(bfv.at(0) == 1);
+    assert(bfv.at(1) == 5);
+    assert(bfv.at(2) == 3);
+    assert(bfv.size() == 3);
+
+    auto      bfv2 = make_bfv_12345();
+    BitSet<5> mask2;
+    mask2.set(0);
+    mask2.set(3);
+    mask2.set(4);
+    bfv2.remove(mask2);
+    assert(bfv2.at(0) == 3);
+    assert(bfv2.at(1) == 2);
+    assert(bfv2.size() == 2);
+}
+
+void
+test_remove_empty_mask_does_nothing()
+{
+    auto      bfv = make_bfv_12345();
+    BitSet<5> mask;
+    bfv.remove(mask);
+    assert(bfv.size() == 5);
+
+    backfill_vector<int, 5> empty;
+    mask.set(0);
+    empty.remove(mask);
+    assert(empty.size() == 0);
+}
+
+void
+test_single_remove_records_move()
+{
+    auto                         bfv = make_bfv_12345();
+    std::array<backfill_move, 1> journal;
+
+    assert(bfv.remove(1, journal) == 1);
+    assert(journal[0].from == 4);
+    assert(journal[0].to == 1);
+
+    // Removing the back element moves nothing.
+    assert(bfv.remove(3, journal) == 0);
+    assert(bfv.size() == 3);
+}
+
+void
+test_batch_remove_journal_patches_parallel_table()
+{
+    auto                         bfv = make_bfv_12345();
+    std::array<int, 5>           ids { 10, 20, 30, 40, 50 };
+    std::array<std::size_t, 3>   idx { 0, 2, 3 };
+    std::array<backfill_move, 3> journal;
+
+    auto moved = bfv.remove(std::span<std::size_t>(idx), journal);
+    // 12345
+    // 5234X
+    // 52XXX
+    assert(moved == 1);
+    assert(bfv.size() == 2);
+
+    for (std::size_t i = 0; i < moved; ++i)
+    {
+        ids[journal[i].to] = ids[journal[i].from];
+    }
+    for (std::size_t i = 0; i < bfv.size(); ++i)
+    {
+        assert(ids[i] == bfv[i] * 10);
+    }
+}
+
+void
+test_mask_remove_journal_matches_span_remove()
+{
+    auto                         a = make_bfv_12345();
+    auto                         b = make_bfv_12345();
+    std::array<std::size_t, 2>   idx { 1, 3 };
+    std::array<backfill_move, 2> journal_a;
+    std::array<backfill_move, 2> journal_b;
+    BitSet<5>                    mask;
+    mask.set(1);
+    mask.set(3);
+
+    auto moved_a = a.remove(std::span<std::size_t>(idx), journal_a);
+    auto moved_b = b.remove(mask, journal_b);
+
+    assert(moved_a == 1);
+    assert(moved_a == moved_b);
+    assert(journal_a[0].from == journal_b[0].from);
+    assert(journal_a[0].to == journal_b[0].to);
+}
+
+void
+test_remove_with_small_journal_throws()
+{
+    auto                         bfv = make_bfv_12345();
+    std::array<std::size_t, 3>   idx { 0, 1, 2 };
+    std::array<backfill_move, 2> journal;
+    BitSet<5>                    mask;
+    mask.set(0);
+    mask.set(1);
+    mask.set(2);
+
+    auto threw = false;
+    try
+    {
+        bfv.remove(std::span<std::size_t>(idx), journal);
+    }
+    catch (std::out_of_range const&)
+    {
+        threw = true;
+    }
+    assert(threw);
+
+    threw = false;
+    try
+    {
+        bfv.remove(mask, journal);
+    }
+    catch (std::out_of_range const&)
+    {
+        threw = true;
+    }
+    assert(threw);
+
+    // Nothing was removed.
+    assert(bfv.size() == 5);
+    for (std::size_t i = 0; i < bfv.size(); ++i)
+    {
+        assert(bfv[i] == Cast(int, i) + 1);
+    }
+}
+
 void
 test_can_iterate_const_items()
 {
@@ -317,6 +481,81 @@ test_back_accesses_correct_element()
     assert(bv[1] == 77);
 }
 
+void
+test_copy_is_independent()
+{
+    auto bfv  = make_bfv_12345();
+    auto copy = bfv;
+
+    copy.remove(0);
+    assert(copy.size() == 4);
+    assert(copy[0] == 5);
+    assert(bfv.size() == 5);
+    assert(bfv[0] == 1);
+}
+
+void
+test_move_takes_storage()
+{
+    auto  bfv   = make_bfv_12345();
+    auto* items = bfv.data();
+
+    auto moved = std::move(bfv);
+    assert(moved.data() == items);
+    assert(moved.size() == 5);
+    assert(moved.at(4) == 5);
+    assert(bfv.size() == 0);
+    assert(bfv.begin() == bfv.end());
+
+    bfv = std::move(moved);
+    assert(bfv.data() == items);
+    assert(bfv.size() == 5);
+}
+
+void
+test_inline_storage()
+{
+    inline_backfill_vector<int, 5> bfv;
+    bfv.allocate();
+    bfv.back() = 1;
+    bfv.allocate();
+    bfv.back() = 2;
+
+    static_assert(sizeof(bfv) >= sizeof(int) * 5);
+    assert(bfv.capacity() == 5);
+
+    auto moved = std::move(bfv);
+    assert(moved.data() != bfv.data());
+    assert(moved.size() == 2);
+    assert(moved[1] == 2);
+    assert(bfv.size() == 0);
+    assert(bfv.capacity() == 5);
+
+    moved.remove(0);
+    assert(moved[0] == 2);
+}
+
+void
+test_arena_storage_is_contiguous()
+{
+    auto arena = Arena_Make(Kilobytes(4));
+    {
+        using ArenaBfv = backfill_vector<int, 4, ArenaAllocator<int>>;
+
+        ArenaBfv a { ArenaAllocator<int>(&arena) };
+        ArenaBfv b { ArenaAllocator<int>(&arena) };
+
+        assert(Cast(UByte*, Cast(void*, a.data())) == arena.base);
+        assert(b.data() == a.data() + 4);
+        assert(arena.used == sizeof(int) * 8);
+
+        a.allocate();
+        a.back() = 7;
+        assert(a.at(0) == 7);
+    }
+    Arena_Free(arena);
+}
+
 void
 test_backfill_vector_main()
 {
@@ -334,9 +573,21 @@ test_backfill_vector_main()
     test_removes_in_backwards_order();
     test_removes_end_sequence();
     test_remove_invalid_indices_does_nothing();
+    test_remove_span_of_indices();
+    test_remove_span_of_every_index();
+    test_remove_mask_matches_remove_indices();
+    test_remove_empty_mask_does_nothing();
+    test_single_remove_records_move();
+    test_batch_remove_journal_patches_parallel_table();
+    test_mask_remove_journal_matches_span_remove();
+    test_remove_with_small_journal_throws();
     test_can_iterate_const_items();
     test_allocation_beyond_capacity_throws();
     test_accessing_elements_before_allocation_throws();
     test_back_accesses_correct_element();
+    test_copy_is_independent();
+    test_move_takes_storage();
+    test_inline_storage();
+    test_arena_storage_is_contiguous();
     printf("TEST BACKFILL complete.\n");
 }
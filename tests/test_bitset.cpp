@@ -0,0 +1,78 @@
+#include "Base/containers/bitset.h"
+#include <cassert>
+#include <cstdio>
+
+void
+Test_BitSet()
+{
+    BitSet<200> bits;
+
+    // Starts with every bit cleared.
+    assert(bits.none());
+    assert(bits.count() == 0);
+    assert(bits.find_first() == bits.size());
+    assert(bits.begin() == bits.end());
+
+    bits.set(3);
+    bits.set(64);
+    bits.set(130);
+    bits.set(199);
+
+    assert(bits.test(3));
+    assert(!bits.test(4));
+    assert(bits[64]);
+    assert(bits.count() == 4);
+
+    // find_next includes the position passed in.
+    assert(bits.find_first() == 3);
+    assert(bits.find_next(3) == 3);
+    assert(bits.find_next(4) == 64);
+    assert(bits.find_next(131) == 199);
+    assert(bits.find_next(200) == bits.size());
+
+    // Iterating yields the indices of the set bits in order.
+    size_t expected[] = { 3, 64, 130, 199 };
+    size_t n          = 0;
+    for (auto index : bits)
+    {
+        assert(index == expected[n]);
+        n += 1;
+    }
+    assert(n == 4);
+
+    // Set operations work across whole sets.
+    BitSet<200> mask;
+    mask.set(64);
+    mask.set(199);
+    mask.set(10);
+
+    assert(bits.intersects(mask));
+    assert(!bits.contains(mask));
+
+    auto both = bits & mask;
+    assert(both.count() == 2);
+    assert(both.test(64) && both.test(199));
+
+    auto either = bits | mask;
+    assert(either.count() == 5);
+    assert(either.contains(bits));
+    assert(either.contains(mask));
+
+    either.and_not(mask);
+    assert(either.count() == 2);
+    assert(either.test(3) && either.test(130));
+
+    bits.reset(3);
+    assert(bits.find_first() == 64);
+
+    bits.clear();
+    assert(bits.none());
+
+    // Free function helper for single words.
+    assert(Bits_IndexOfFirstSet(0) == -1);
+    assert(Bits_IndexOfFirstSet(0x01) == 0);
+    assert(Bits_IndexOfFirstSet(0x04) == 2);
+    assert(Bits_IndexOfFirstSet(0x06) == 1);
+
+    printf("TEST BITSET complete.\n");
+}
@@ -0,0 +1,153 @@
+#include "Base/kernels/collision.h"
+#include "Base/platform/platform.h"
+#include <cassert>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+// Odd so every SIMD kernel has a scalar tail.
+constexpr size_t COLLISION_TEST_COUNT = 1027;
+
+struct CollisionColumns
+{
+    std::vector<float> x, y, w, h;
+
+    CollisionBoxes
+    boxes() const
+    {
+        return { x.data(), y.data(), w.data(), h.data() };
+    }
+
+    void
+    push(float bx, float by, float bw, float bh)
+    {
+        x.push_back(bx);
+        y.push_back(by);
+        w.push_back(bw);
+        h.push_back(bh);
+    }
+};
+
+static CollisionColumns
+Collision_RandomBoxes(std::mt19937& rng)
+{
+    // Whole numbers, so boxes often touch exactly.
+    std::uniform_int_distribution<int> position(-20, 20);
+    std::uniform_int_distribution<int> size(1, 10);
+
+    CollisionColumns columns;
+    for (size_t i = 0; i < COLLISION_TEST_COUNT; ++i)
+    {
+        columns.push(Cast(float, position(rng)),
+                     Cast(float, position(rng)),
+                     Cast(float, size(rng)),
+                     Cast(float, size(rng)));
+    }
+    return columns;
+}
+
+static void
+Collision_CheckHits(std::vector<uint64> const& hits, std::vector<uint64> const& expected)
+{
+    assert(hits == expected);
+    // Nothing past the last test.
+    assert((hits.back() >> (COLLISION_TEST_COUNT % 64)) == 0);
+}
+
+void
+Test_Collision()
+{
+    std::mt19937     rng(77);
+    CollisionColumns a = Collision_RandomBoxes(rng);
+    CollisionColumns b = Collision_RandomBoxes(rng);
+
+    std::vector<float> px, py;
+    std::uniform_int_distribution<int> point(-20, 30);
+    for (size_t i = 0; i < COLLISION_TEST_COUNT; ++i)
+    {
+        px.push_back(Cast(float, point(rng)));
+        py.push_back(Cast(float, point(rng)));
+    }
+
+    size_t const words = Collision_HitWords(COLLISION_TEST_COUNT);
+
+    // The scalar kernels against the definitions.
+    std::vector<uint64> overlaps(words, ~uint64(0)), inside(words, ~uint64(0));
+    Collision_OverlapScalar(a.boxes(), b.boxes(), COLLISION_TEST_COUNT, overlaps.data());
+    Collision_PointInBoxScalar(px.data(),
+                               py.data(),
+                               a.boxes(),
+                               COLLISION_TEST_COUNT,
+                               inside.data());
+
+    size_t n_overlaps = 0, n_inside = 0;
+    for (size_t i = 0; i < COLLISION_TEST_COUNT; ++i)
+    {
+        bool overlap = a.x[i] < b.x[i] + b.w[i] && b.x[i] < a.x[i] + a.w[i]
+                       && a.y[i] < b.y[i] + b.h[i] && b.y[i] < a.y[i] + a.h[i];
+        bool in = a.x[i] <= px[i] && px[i] < a.x[i] + a.w[i] && a.y[i] <= py[i]
+                  && py[i] < a.y[i] + a.h[i];
+        assert(Collision_IsHit(overlaps.data(), i) == overlap);
+        assert(Collision_IsHit(inside.data(), i) == in);
+        n_overlaps += overlap;
+        n_inside += in;
+    }
+    assert(n_overlaps > 0 && n_overlaps < COLLISION_TEST_COUNT);
+    assert(n_inside > 0 && n_inside < COLLISION_TEST_COUNT);
+
+    // A diagonal ray, through boxes along the way, and one along an axis.
+    CollisionRay const diagonal { -25.0f, -25.0f, 1.0f / 40.0f, 1.0f / 40.0f, 1.0f };
+    CollisionRay const across { -30.0f, 0.5f, 1.0f, INFINITY, 100.0f };
+
+    std::vector<uint64> diagonal_hits(words), across_hits(words);
+    Collision_RayScalar(diagonal, a.boxes(), COLLISION_TEST_COUNT, diagonal_hits.data());
+    Collision_RayScalar(across, a.boxes(), COLLISION_TEST_COUNT, across_hits.data());
+    for (size_t i = 0; i < COLLISION_TEST_COUNT; ++i)
+    {
+        // The diagonal goes from (-25, -25) to (15, 15), x == y along the way.
+        float lo = std::fmax(a.x[i], a.y[i]), hi = std::fmin(a.x[i] + a.w[i], a.y[i] + a.h[i]);
+        if (lo < hi && hi > -25.0f && lo < 15.0f)
+        {
+            assert(Collision_IsHit(diagonal_hits.data(), i));
+        }
+        if (!(lo <= hi))
+        {
+            assert(!Collision_IsHit(diagonal_hits.data(), i));
+        }
+
+        bool spans_y = a.y[i] < 0.5f && 0.5f < a.y[i] + a.h[i];
+        assert(Collision_IsHit(across_hits.data(), i) == spans_y);
+    }
+
+    // Every kernel gives the scalar kernels' hits.
+    auto check = [&](auto overlap_kernel, auto point_kernel, auto ray_kernel) {
+        std::vector<uint64> hits(words, ~uint64(0));
+        overlap_kernel(a.boxes(), b.boxes(), COLLISION_TEST_COUNT, hits.data());
+        Collision_CheckHits(hits, overlaps);
+
+        std::fill(hits.begin(), hits.end(), ~uint64(0));
+        point_kernel(px.data(), py.data(), a.boxes(), COLLISION_TEST_COUNT, hits.data());
+        Collision_CheckHits(hits, inside);
+
+        std::fill(hits.begin(), hits.end(), ~uint64(0));
+        ray_kernel(diagonal, a.boxes(), COLLISION_TEST_COUNT, hits.data());
+        Collision_CheckHits(hits, diagonal_hits);
+        ray_kernel(across, a.boxes(), COLLISION_TEST_COUNT, hits.data());
+        Collision_CheckHits(hits, across_hits);
+    };
+
+    check(Collision_Overlap, Collision_PointInBox, Collision_Ray);
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64)
+    check(Collision_OverlapSse2, Collision_PointInBoxSse2, Collision_RaySse2);
+    if (Platform_CpuHasAvx2())
+    {
+        check(Collision_OverlapAvx2, Collision_PointInBoxAvx2, Collision_RayAvx2);
+    }
+#endif
+
+    // Nothing to do.
+    Collision_Overlap(a.boxes(), b.boxes(), 0, nullptr);
+
+    printf("TEST COLLISION complete.\n");
+}
@@ -0,0 +1,373 @@
+#include "Base/ecs/ecs.h"
+#include "Base/ecs/ecs_view.h"
+#include <cassert>
+#include <cstdio>
+#include <optional>
+#include <vector>
+
+namespace
+{
+struct Position
+{
+    float x, y;
+};
+
+struct Velocity
+{
+    float x, y;
+};
+
+struct Tag
+{
+};
+
+// Counts live instances to check that moves between archetypes don't leak.
+struct Tracked
+{
+    static inline int live = 0;
+
+    std::vector<int> values;
+
+    Tracked()
+    {
+        live += 1;
+    }
+    Tracked(Tracked&& other) noexcept
+        : values(std::move(other.values))
+    {
+        live += 1;
+    }
+    Tracked&
+    operator=(Tracked&&) = default;
+    ~Tracked()
+    {
+        live -= 1;
+    }
+};
+} // namespace
+
+
+void
+Test_EcsCreateAndGet()
+{
+    EcsWorld world;
+
+    auto a = Ecs_Create(world, Ecs_Mask<Position, Velocity>());
+    auto b = Ecs_Create(world, Ecs_Mask<Position>());
+    assert(Ecs_EntityCount(world) == 2);
+
+    // Entities with different components go to different archetypes.
+    assert(world.entities.get(a)->archetype != world.entities.get(b)->archetype);
+
+    Ecs_Get<Position>(world, a)->x = 1;
+    Ecs_Get<Position>(world, b)->x = 2;
+    assert(Ecs_Get<Position>(world, a)->x == 1);
+    assert(Ecs_Get<Velocity>(world, a)->x == 0);
+    assert(Ecs_Get<Velocity>(world, b) == nullptr);
+    assert(Ecs_Has<Velocity>(world, a));
+    assert(!Ecs_Has<Velocity>(world, b));
+
+    // Each column is cache line aligned.
+    auto* archetype = Ecs_GetArchetype(world, Ecs_Mask<Position, Velocity>());
+    for (auto type : archetype->types)
+    {
+        assert(archetype->column_offsets[type] % ECS_COLUMN_ALIGNMENT == 0);
+    }
+
+    assert(Ecs_Destroy(world, a));
+    assert(!Ecs_Destroy(world, a));
+    assert(!Ecs_IsAlive(world, a));
+    assert(Ecs_Get<Position>(world, a) == nullptr);
+    assert(Ecs_Get<Position>(world, b)->x == 2);
+}
+
+
+void
+Test_EcsChunksStayPacked()
+{
+    EcsWorld world;
+
+    auto*                  archetype = Ecs_GetArchetype(world, Ecs_Mask<Position, Velocity>());
+    uint32                 n         = archetype->chunk_capacity * 2 + 3;
+    std::vector<EcsEntity> entities;
+    for (uint32 i = 0; i < n; ++i)
+    {
+        auto entity = Ecs_Create(world, Ecs_Mask<Position, Velocity>());
+        Ecs_Get<Position>(world, entity)->x = float(i);
+        entities.push_back(entity);
+    }
+    assert(archetype->chunks.size() == 3);
+    assert(archetype->entity_count == n);
+
+    // Destroy every other entity, the survivors keep their values and every
+    // chunk except the last stays full.
+    for (uint32 i = 0; i < n; i += 2)
+    {
+        Ecs_Destroy(world, entities[i]);
+    }
+    for (uint32 i = 1; i < n; i += 2)
+    {
+        assert(Ecs_Get<Position>(world, entities[i])->x == float(i));
+    }
+    for (size_t c = 0; c + 1 < archetype->chunks.size(); ++c)
+    {
+        assert(archetype->chunks[c].count == archetype->chunk_capacity);
+    }
+
+    // The entity column maps each row back to its entity.
+    for (auto& chunk : archetype->chunks)
+    {
+        auto positions = EcsChunk_Column<Position>(*archetype, chunk);
+        auto handles   = EcsChunk_Entities(chunk);
+        for (uint32 row = 0; row < chunk.count; ++row)
+        {
+            assert(&positions[row] == Ecs_Get<Position>(world, handles[row]));
+        }
+    }
+}
+
+
+void
+Test_EcsAddRemoveComponents()
+{
+    EcsWorld world;
+
+    auto entity = Ecs_Create(world, Ecs_Mask<Position>());
+    Ecs_Get<Position>(world, entity)->x = 5;
+
+    auto* velocity = Ecs_Add<Velocity>(world, entity, { 1, 2 });
+    assert(velocity->y == 2);
+    assert(Ecs_Get<Position>(world, entity)->x == 5);
+
+    Ecs_Add<Tracked>(world, entity)->values.push_back(7);
+    assert(Tracked::live == 1);
+    assert(Ecs_Get<Tracked>(world, entity)->values[0] == 7);
+
+    assert(Ecs_Remove<Velocity>(world, entity));
+    assert(!Ecs_Remove<Velocity>(world, entity));
+    assert(Ecs_Get<Velocity>(world, entity) == nullptr);
+    assert(Ecs_Get<Position>(world, entity)->x == 5);
+    assert(Ecs_Get<Tracked>(world, entity)->values[0] == 7);
+    assert(Tracked::live == 1);
+
+    // Components without data still make their own archetype.
+    Ecs_Add<Tag>(world, entity);
+    assert(Ecs_Has<Tag>(world, entity));
+
+    Ecs_Destroy(world, entity);
+    assert(Tracked::live == 0);
+
+    auto other = Ecs_Create(world, Ecs_Mask<Tracked>());
+    Ecs_Get<Tracked>(world, other)->values.push_back(1);
+    Ecs_Clear(world);
+    assert(Tracked::live == 0);
+    assert(Ecs_EntityCount(world) == 0);
+}
+
+
+void
+Test_EcsEach()
+{
+    EcsWorld world;
+
+    for (int i = 0; i < 10; ++i)
+    {
+        Ecs_Add<Velocity>(world, Ecs_Create(world, Ecs_Mask<Position>()), { 1, 0 });
+        Ecs_Create(world, Ecs_Mask<Position>());
+    }
+
+    Ecs_Each<Position, Velocity>(world, [](Position& position, Velocity& velocity) {
+        position.x += velocity.x;
+    });
+
+    float sum     = 0;
+    int   visited = 0;
+    Ecs_Each<Position>(world, [&](Position& position) {
+        sum += position.x;
+        visited += 1;
+    });
+    assert(sum == 10);
+    assert(visited == 20);
+}
+
+
+void
+Test_EcsView()
+{
+    EcsWorld world;
+
+    EcsView<Position, Velocity const> moving;
+    EcsView<Position>                 still { Ecs_Mask<Velocity>() };
+
+    Ecs_Create(world, Ecs_Mask<Position, Velocity>());
+    Ecs_Create(world, Ecs_Mask<Position>());
+    assert(moving.count(world) == 1);
+    assert(still.count(world) == 1);
+    assert(moving.matches.size() == 1);
+
+    // The cache only changes when a new archetype appears.
+    uint64 version = moving.version;
+    Ecs_Create(world, Ecs_Mask<Position, Velocity>());
+    assert(moving.count(world) == 2);
+    assert(moving.version == version);
+
+    auto entity = Ecs_Create(world, Ecs_Mask<Position, Velocity, Tag>());
+    Ecs_Get<Velocity>(world, entity)->x = 3;
+    assert(moving.count(world) == 3);
+    assert(moving.matches.size() == 2);
+    assert(moving.version != version);
+
+    moving.each(world, [](Position& position, Velocity const& velocity) {
+        position.x += velocity.x + 1;
+    });
+    assert(Ecs_Get<Position>(world, entity)->x == 4);
+
+    float sum = 0;
+    for (auto [position, velocity] : moving.iterate(world))
+    {
+        sum += position.x;
+    }
+    assert(sum == 6);
+
+    int visited = 0;
+    for (auto [position] : still.iterate(world))
+    {
+        assert(position.x == 0);
+        visited += 1;
+    }
+    assert(visited == 1);
+
+    EcsView<Tracked> empty;
+    assert(empty.iterate(world).begin() == empty.iterate(world).end());
+
+    // A new world built where an old one was, at the same structure version,
+    // must still be looked at afresh.
+    std::optional<EcsWorld> slot;
+    EcsView<Position>       positions;
+    slot.emplace();
+    Ecs_Create(*slot, Ecs_Mask<Position>());
+    assert(positions.count(*slot) == 1);
+
+    EcsWorld const* address = &*slot;
+    slot.reset();
+    slot.emplace();
+    assert(&*slot == address);
+    Ecs_Create(*slot, Ecs_Mask<Velocity>());
+    assert(positions.count(*slot) == 0);
+    assert(positions.matches.empty());
+}
+
+
+void
+Test_EcsCreateMany()
+{
+    EcsWorld world;
+
+    // More than a chunk holds, on top of an entity made one at a time.
+    auto first = Ecs_Create(world, Ecs_Mask<Position, Tracked>());
+
+    std::vector<EcsEntity> entities(2000);
+    Ecs_CreateMany(world, Ecs_Mask<Position, Tracked>(), entities);
+    assert(Ecs_EntityCount(world) == 2001);
+    assert(Tracked::live == 2001);
+
+    auto& archetype = *world.archetypes[world.entities.get(first)->archetype];
+    assert(archetype.entity_count == 2001);
+    assert(archetype.chunks.size() > 1);
+    for (size_t i = 0; i + 1 < archetype.chunks.size(); ++i)
+    {
+        assert(archetype.chunks[i].count == archetype.chunk_capacity);
+    }
+
+    // Each handle finds its own row.
+    for (size_t i = 0; i < entities.size(); ++i)
+    {
+        Ecs_Get<Position>(world, entities[i])->x = float(i);
+    }
+    for (size_t i = 0; i < entities.size(); ++i)
+    {
+        auto location = *world.entities.get(entities[i]);
+        assert(EcsChunk_Entities(archetype.chunks[location.chunk])[location.row] == entities[i]);
+        assert(Ecs_Get<Position>(world, entities[i])->x == float(i));
+    }
+
+    // Gains Velocity and loses Tracked in one move.
+    assert(Ecs_ChangeComponents(world, first, Ecs_Mask<Position, Velocity>()));
+    assert(Ecs_Has<Velocity>(world, first) && !Ecs_Has<Tracked>(world, first));
+    assert(Tracked::live == 2000);
+
+    Ecs_Clear(world);
+    assert(Tracked::live == 0);
+    assert(!Ecs_ChangeComponents(world, first, Ecs_Mask<Position>()));
+}
+
+
+void
+Test_EcsChangeDetection()
+{
+    EcsWorld world;
+
+    auto a = Ecs_Create(world, Ecs_Mask<Position, Velocity>());
+    auto b = Ecs_Create(world, Ecs_Mask<Position, Velocity, Tag>());
+
+    EcsView<Position const> reader;
+    auto                    changed = [&] {
+        int chunks = 0;
+        reader.each_chunk_changed(world, [&](EcsChunk&, std::span<Position const>) {
+            chunks += 1;
+        });
+        return chunks;
+    };
+
+    // Everything is new the first time.
+    assert(changed() == 2);
+    assert(changed() == 0);
+
+    // Reads don't count as changes.
+    assert(Ecs_Get<Position const>(world, a)->x == 0);
+    assert(Ecs_Has<Position>(world, b));
+    Ecs_Each<Position const>(world, [](Position const&) {});
+    assert(changed() == 0);
+
+    // Writes do, a chunk's column at a time.
+    Ecs_Get<Position>(world, a)->x = 1;
+    assert(changed() == 1);
+
+    Ecs_Each<Velocity>(world, [](Velocity& velocity) { velocity.x = 1; });
+    assert(changed() == 0);
+
+    EcsView<Position, Velocity const> writer;
+    writer.each(world, [](Position& position, Velocity const& velocity) {
+        position.x += velocity.x;
+    });
+    assert(changed() == 2);
+
+    // A view filtering on what it writes doesn't see its own writes.
+    EcsView<Position> self;
+    assert(self.changed_filter == Ecs_Mask<Position>());
+    self.each_changed(world, [](Position& position) { position.y += 1; });
+    int visited = 0;
+    self.each_changed(world, [&](Position&) { visited += 1; });
+    assert(visited == 0);
+    assert(changed() == 2);
+
+    // Rows being added count as changes to every column of their chunk.
+    Ecs_Create(world, Ecs_Mask<Position, Velocity>());
+    assert(changed() == 1);
+    Ecs_Destroy(world, b);
+    assert(changed() == 0);
+}
+
+
+void
+Test_Ecs()
+{
+    Test_EcsCreateAndGet();
+    Test_EcsChunksStayPacked();
+    Test_EcsAddRemoveComponents();
+    Test_EcsEach();
+    Test_EcsView();
+    Test_EcsCreateMany();
+    Test_EcsChangeDetection();
+    printf("TEST ECS complete.\n");
+}
@@ -0,0 +1,153 @@
+#include "Base/ecs/ecs_commands.h"
+#include "Base/worker_pool.h"
+#include <cassert>
+#include <cstdio>
+#include <vector>
+
+namespace
+{
+struct CmdPosition
+{
+    float x, y;
+};
+
+struct CmdHealth
+{
+    int value;
+};
+
+// Counts live instances, including the values waiting in command buffers.
+struct CmdTracked
+{
+    static inline int live = 0;
+
+    std::vector<int> values;
+
+    CmdTracked()
+    {
+        live += 1;
+    }
+    CmdTracked(CmdTracked&& other) noexcept
+        : values(std::move(other.values))
+    {
+        live += 1;
+    }
+    CmdTracked&
+    operator=(CmdTracked&&) = default;
+    ~CmdTracked()
+    {
+        live -= 1;
+    }
+};
+
+struct SpawnJob
+{
+    EcsCommands* commands;
+    int          n;
+};
+
+void
+Spawn(void* data, uint32)
+{
+    auto& job    = *static_cast<SpawnJob*>(data);
+    auto& buffer = EcsCommands_Local(*job.commands);
+    for (int i = 0; i < job.n; ++i)
+    {
+        EcsEntity entity = EcsCommandBuffer_Create(buffer, Ecs_Mask<CmdPosition>());
+        EcsCommandBuffer_Add(buffer, entity, CmdHealth { i });
+    }
+}
+} // namespace
+
+
+void
+Test_EcsCommands()
+{
+    EcsWorld    world;
+    EcsCommands commands;
+    EcsCommands_Init(commands, 1);
+
+    auto& buffer = EcsCommands_Local(commands);
+
+    // Nothing changes until the commands are applied.
+    EcsEntity pending = EcsCommandBuffer_Create(buffer, Ecs_Mask<CmdPosition>());
+    assert(Ecs_IsPending(pending));
+    EcsCommandBuffer_Add(buffer, pending, CmdPosition { 1.0f, 2.0f });
+    EcsCommandBuffer_Add(buffer, pending, CmdHealth { 10 });
+    assert(Ecs_EntityCount(world) == 0);
+
+    Ecs_ApplyCommands(world, commands);
+    EcsEntity entity = EcsCommandBuffer_Resolve(buffer, pending);
+    assert(Ecs_IsAlive(world, entity));
+    assert(Ecs_Get<CmdPosition>(world, entity)->y == 2.0f);
+    assert(Ecs_Get<CmdHealth>(world, entity)->value == 10);
+    assert(buffer.commands.empty());
+
+    // The last value wins, a later remove drops the value, and each entity
+    // moves archetype once.
+    auto other = Ecs_Create(world, Ecs_Mask<CmdPosition>());
+    EcsCommandBuffer_Add(buffer, entity, CmdTracked {});
+    EcsCommandBuffer_Add(buffer, entity, CmdHealth { 20 });
+    EcsCommandBuffer_Add(buffer, other, CmdHealth { 1 });
+    EcsCommandBuffer_Add(buffer, entity, CmdHealth { 30 });
+    EcsCommandBuffer_Remove<CmdTracked>(buffer, entity);
+    EcsCommandBuffer_Remove<CmdPosition>(buffer, other);
+    assert(CmdTracked::live == 1);
+
+    uint64 archetypes = world.archetypes.size();
+    Ecs_ApplyCommands(world, commands);
+    assert(world.archetypes.size() == archetypes + 1); // Only {CmdHealth} is new.
+    assert(Ecs_Get<CmdHealth>(world, entity)->value == 30);
+    assert(!Ecs_Has<CmdTracked>(world, entity));
+    assert(!Ecs_Has<CmdPosition>(world, other));
+    assert(Ecs_Get<CmdHealth>(world, other)->value == 1);
+    assert(CmdTracked::live == 0);
+
+    // Adding a component without a value keeps the one it has.
+    EcsCommandBuffer_AddComponent(buffer, entity, Ecs_TypeId<CmdHealth>());
+    Ecs_ApplyCommands(world, commands);
+    assert(Ecs_Get<CmdHealth>(world, entity)->value == 30);
+
+    // Destroying drops the entity's other commands, and stale entities are skipped.
+    EcsCommandBuffer_Add(buffer, entity, CmdTracked {});
+    EcsCommandBuffer_Destroy(buffer, entity);
+    EcsCommandBuffer_Add(buffer, entity, CmdHealth { 40 });
+    Ecs_ApplyCommands(world, commands);
+    assert(!Ecs_IsAlive(world, entity));
+    assert(CmdTracked::live == 0);
+
+    EcsCommandBuffer_Add(buffer, entity, CmdTracked {});
+    Ecs_ApplyCommands(world, commands);
+    assert(CmdTracked::live == 0);
+
+    // Clearing drops values that were never applied.
+    EcsCommandBuffer_Add(buffer, other, CmdTracked {});
+    EcsCommandBuffer_Clear(buffer);
+    assert(CmdTracked::live == 0);
+    Ecs_ApplyCommands(world, commands);
+    assert(!Ecs_Has<CmdTracked>(world, other));
+
+    // Recording from several threads at once.
+    {
+        WorkerPool pool;
+        WorkerPool_Init(pool, 3);
+        EcsCommands_Init(commands, WorkerPool_ThreadCount(pool));
+
+        SpawnJob job { &commands, 100 };
+        for (int i = 0; i < 40; ++i)
+        {
+            WorkerPool_Push(pool, { &Spawn, &job });
+        }
+        WorkerPool_Wait(pool);
+
+        size_t before = Ecs_EntityCount(world);
+        Ecs_ApplyCommands(world, commands);
+        assert(Ecs_EntityCount(world) == before + 4000);
+
+        int count = 0;
+        Ecs_Each<CmdHealth const>(world, [&](CmdHealth const&) { count += 1; });
+        assert(count == 4000 + 1);
+    }
+
+    printf("TEST ECSCOMMANDS complete.\n");
+}
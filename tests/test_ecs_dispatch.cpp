@@ -0,0 +1,85 @@
+#include "Base/ecs/ecs_dispatch.h"
+#include <cassert>
+#include <cstdio>
+#include <vector>
+
+namespace
+{
+struct Calls
+{
+    std::vector<std::vector<EcsEntity>> seen;
+};
+
+using DispatchHandler = void (*)(Calls& calls, std::span<EcsEntity const> entities);
+
+void
+Handler_A(Calls& calls, std::span<EcsEntity const> entities)
+{
+    calls.seen.emplace_back(entities.begin(), entities.end());
+}
+
+void
+Handler_B(Calls& calls, std::span<EcsEntity const> entities)
+{
+    calls.seen.emplace_back(entities.begin(), entities.end());
+    calls.seen.back().push_back(SLOT_HANDLE_INVALID); // Tells B's calls apart from A's.
+}
+} // namespace
+
+
+void
+Test_EcsDispatch()
+{
+    EcsDispatch<DispatchHandler> dispatch;
+
+    // Entities alternating between two handlers, B seen first.
+    std::vector<EcsEntity> a_entities, b_entities;
+    for (uint32 i = 0; i < 100; ++i)
+    {
+        EcsEntity entity { i, 1 };
+        if (i % 3 == 0)
+        {
+            dispatch.add(&Handler_B, entity);
+            b_entities.push_back(entity);
+        }
+        else
+        {
+            dispatch.add(&Handler_A, entity);
+            a_entities.push_back(entity);
+        }
+    }
+    assert(dispatch.size() == 100);
+    assert(dispatch.buckets.size() == 2);
+
+    Calls                        calls;
+    std::vector<DispatchHandler> order;
+    dispatch.run([&](DispatchHandler handler, std::span<EcsEntity const> entities) {
+        order.push_back(handler);
+        handler(calls, entities);
+    });
+
+    // Each handler once, in first-seen order, with its entities in the order added.
+    assert(order.size() == 2);
+    assert(order[0] == &Handler_B && order[1] == &Handler_A);
+    b_entities.push_back(SLOT_HANDLE_INVALID);
+    assert(calls.seen[0] == b_entities);
+    assert(calls.seen[1] == a_entities);
+
+    // Clearing keeps the buckets, and empty buckets aren't run.
+    dispatch.clear();
+    assert(dispatch.size() == 0);
+    assert(dispatch.buckets.size() == 2);
+
+    dispatch.add(&Handler_A, EcsEntity { 7, 2 });
+    calls.seen.clear();
+    order.clear();
+    dispatch.run([&](DispatchHandler handler, std::span<EcsEntity const> entities) {
+        order.push_back(handler);
+        handler(calls, entities);
+    });
+    assert(order.size() == 1 && order[0] == &Handler_A);
+    assert(calls.seen.size() == 1 && calls.seen[0].size() == 1);
+    assert(calls.seen[0][0] == (EcsEntity { 7, 2 }));
+
+    printf("TEST ECSDISPATCH complete.\n");
+}
@@ -0,0 +1,214 @@
+#include "Base/ecs/ecs_file.h"
+#include <cassert>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+namespace
+{
+struct FilePosition
+{
+    float x, y;
+};
+
+struct FileHealth
+{
+    int value;
+};
+
+struct FileScore
+{
+    int value;
+};
+
+struct FileTag
+{
+};
+
+struct FileName
+{
+    std::vector<char> text;
+};
+} // namespace
+
+
+void
+Test_EcsFile()
+{
+    EcsWorld world;
+
+    std::vector<EcsEntity> entities;
+    for (int i = 0; i < 3000; ++i)
+    {
+        auto mask   = (i % 2) == 0 ? Ecs_Mask<FilePosition, FileHealth>()
+                                   : Ecs_Mask<FilePosition>();
+        auto entity = Ecs_Create(world, mask);
+        *Ecs_Get<FilePosition>(world, entity) = { Cast(float, i), Cast(float, -i) };
+        if ((i % 2) == 0)
+        {
+            Ecs_Get<FileHealth>(world, entity)->value = i;
+        }
+        entities.push_back(entity);
+    }
+    // Leave holes in the entity index, so the free list is saved too.
+    for (int i = 0; i < 3000; i += 5)
+    {
+        Ecs_Destroy(world, entities[i]);
+    }
+
+    std::vector<UByte> image;
+    assert(Ecs_SaveWorld(world, image) == EcsFileError::NO_ERROR);
+
+    // Load into a world whose archetypes are numbered differently.
+    EcsWorld other;
+    Ecs_Create(other, Ecs_Mask<FileTag>());
+    Ecs_Create(other, Ecs_Mask<FileHealth>());
+    assert(Ecs_LoadWorld(other, image) == EcsFileError::NO_ERROR);
+    assert(Ecs_EntityCount(other) == Ecs_EntityCount(world));
+    for (int i = 0; i < 3000; ++i)
+    {
+        if ((i % 5) == 0)
+        {
+            assert(!Ecs_IsAlive(other, entities[i]));
+            continue;
+        }
+        auto const* p = Ecs_Get<FilePosition const>(other, entities[i]);
+        assert(p->x == Cast(float, i) && p->y == Cast(float, -i));
+        assert(Ecs_Has<FileHealth>(other, entities[i]) == ((i % 2) == 0));
+        if ((i % 2) == 0)
+        {
+            assert(Ecs_Get<FileHealth const>(other, entities[i])->value == i);
+        }
+    }
+
+    // The loaded world carries on like the saved one, reusing the freed slots.
+    EcsEntity a = Ecs_Create(world, Ecs_Mask<FilePosition>());
+    EcsEntity b = Ecs_Create(other, Ecs_Mask<FilePosition>());
+    assert(a == b);
+    assert(Ecs_Destroy(other, entities[1]));
+    assert(Ecs_Get<FileHealth const>(other, entities[2])->value == 2);
+    Ecs_Destroy(world, a);
+
+    // A broken image is turned down without touching the world.
+    size_t count = Ecs_EntityCount(other);
+    {
+        auto broken = image;
+        broken[0] ^= 0xff;
+        assert(Ecs_LoadWorld(other, broken) == EcsFileError::BAD_HEADER);
+
+        broken = image;
+        broken.pop_back();
+        assert(Ecs_LoadWorld(other, broken) == EcsFileError::BAD_HEADER);
+
+        EcsFileHeader header;
+        broken = image;
+        std::memcpy(&header, broken.data(), sizeof(header));
+        header.chunks = broken.size() - 8;
+        std::memcpy(broken.data(), &header, sizeof(header));
+        assert(Ecs_LoadWorld(other, broken) == EcsFileError::CORRUPT);
+
+        EcsFileComponent component;
+        broken = image;
+        std::memcpy(&component, broken.data() + header.components, sizeof(component));
+        broken[component.name] ^= 0xff;
+        assert(Ecs_LoadWorld(other, broken) == EcsFileError::UNKNOWN_COMPONENT);
+
+        // Not even the archetypes are made when a chunk turns out to be bad.
+        EcsFileChunk chunk;
+        std::memcpy(&header, image.data(), sizeof(header));
+        broken = image;
+        std::memcpy(&chunk, broken.data() + header.chunks, sizeof(chunk));
+        chunk.count = 0;
+        std::memcpy(broken.data() + header.chunks, &chunk, sizeof(chunk));
+        EcsWorld fresh;
+        assert(Ecs_LoadWorld(fresh, broken) == EcsFileError::CORRUPT);
+        assert(fresh.archetypes.empty());
+    }
+    assert(Ecs_EntityCount(other) == count);
+
+    // Images whose tables are each in range, but don't agree with each other.
+    {
+        EcsWorld               small;
+        std::vector<EcsEntity> handles;
+        for (int i = 0; i < 6; ++i)
+        {
+            auto mask = (i % 2) == 0 ? Ecs_Mask<FileHealth>() : Ecs_Mask<FileScore>();
+            handles.push_back(Ecs_Create(small, mask));
+        }
+        Ecs_Destroy(small, handles[2]);
+        Ecs_Destroy(small, handles[4]);
+
+        std::vector<UByte> small_image;
+        assert(Ecs_SaveWorld(small, small_image) == EcsFileError::NO_ERROR);
+
+        EcsFileHeader small_header;
+        std::memcpy(&small_header, small_image.data(), sizeof(small_header));
+        auto read = [&](auto& value, uint64 offset) {
+            std::memcpy(&value, small_image.data() + offset, sizeof(value));
+        };
+        auto write = [](std::vector<UByte>& to, uint64 offset, auto const& value) {
+            std::memcpy(to.data() + offset, &value, sizeof(value));
+        };
+
+        // Both archetypes have the same mask.
+        assert(small_header.column_count == 2);
+        uint32 column;
+        read(column, small_header.columns);
+        auto broken = small_image;
+        write(broken, small_header.columns + sizeof(uint32), column);
+        assert(Ecs_LoadWorld(other, broken) == EcsFileError::CORRUPT);
+
+        // Two entities in the same row.
+        EcsLocation location;
+        read(location, small_header.locations);
+        broken = small_image;
+        write(broken, small_header.locations + sizeof(EcsLocation), location);
+        assert(Ecs_LoadWorld(other, broken) == EcsFileError::CORRUPT);
+
+        // A live entity on the free list. The last entity was moved into the
+        // first hole, so the list runs on from it through that hole and is
+        // still as long as it should be.
+        uint32 slot;
+        read(slot, small_header.dense_to_slot + (2 * sizeof(uint32)));
+        broken = small_image;
+        small_header.free_head = slot;
+        write(broken, 0, small_header);
+        assert(Ecs_LoadWorld(other, broken) == EcsFileError::CORRUPT);
+        read(small_header, 0);
+
+        // A chunk holding a stale handle.
+        EcsFileChunk chunk;
+        EcsEntity    entity;
+        read(chunk, small_header.chunks);
+        read(entity, chunk.offset);
+        entity.generation += 1;
+        broken = small_image;
+        write(broken, chunk.offset, entity);
+        assert(Ecs_LoadWorld(other, broken) == EcsFileError::CORRUPT);
+
+        EcsWorld loaded_small;
+        assert(Ecs_LoadWorld(loaded_small, small_image) == EcsFileError::NO_ERROR);
+        assert(Ecs_EntityCount(loaded_small) == 4);
+    }
+    assert(Ecs_EntityCount(other) == count);
+
+    // Components that aren't trivially copyable can't be saved.
+    {
+        EcsWorld named;
+        Ecs_Create(named, Ecs_Mask<FileName>());
+        std::vector<UByte> named_image;
+        assert(Ecs_SaveWorld(named, named_image) == EcsFileError::NOT_TRIVIALLY_COPYABLE);
+    }
+
+    // And through a file.
+    char const* path = "test_ecs_file.bin";
+    assert(Ecs_SaveWorldFile(world, path) == EcsFileError::NO_ERROR);
+    EcsWorld loaded;
+    assert(Ecs_LoadWorldFile(loaded, path) == EcsFileError::NO_ERROR);
+    assert(Ecs_EntityCount(loaded) == Ecs_EntityCount(world));
+    assert(Ecs_Get<FileHealth const>(loaded, entities[2])->value == 2);
+    remove(path);
+    assert(Ecs_LoadWorldFile(loaded, path) == EcsFileError::OPEN_ERROR);
+
+    printf("TEST ECS FILE complete.\n");
+}
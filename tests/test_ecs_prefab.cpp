@@ -0,0 +1,73 @@
+#include "Base/ecs/ecs_prefab.h"
+#include <cassert>
+#include <cstdio>
+#include <vector>
+
+namespace
+{
+struct PrefabPosition
+{
+    float x, y;
+};
+
+struct PrefabHealth
+{
+    int value { 7 };
+};
+
+struct PrefabLoot
+{
+    std::vector<int> items;
+};
+} // namespace
+
+
+void
+Test_EcsPrefab()
+{
+    EcsWorld world;
+
+    EcsPrefab prefab;
+    EcsPrefab_Set(prefab, PrefabPosition { 1.0f, 2.0f });
+    EcsPrefab_Add<PrefabHealth>(prefab);
+    EcsPrefab_Set(prefab, PrefabLoot { { 1, 2, 3 } });
+    assert(prefab.mask == (Ecs_Mask<PrefabPosition, PrefabHealth, PrefabLoot>()));
+
+    // Setting a component again replaces its value.
+    EcsPrefab_Set(prefab, PrefabPosition { 3.0f, 4.0f });
+
+    // Enough entities to fill several chunks, after one made the usual way.
+    EcsEntity first = Ecs_Create(world, prefab.mask);
+
+    std::vector<EcsEntity> wave(5000);
+    EcsPrefab_Instantiate(world, prefab, wave);
+    assert(Ecs_EntityCount(world) == 5001);
+    assert(Ecs_Get<PrefabLoot const>(world, first)->items.empty());
+    for (auto entity : wave)
+    {
+        auto const* position = Ecs_Get<PrefabPosition const>(world, entity);
+        assert(position->x == 3.0f && position->y == 4.0f);
+        assert(Ecs_Get<PrefabHealth const>(world, entity)->value == 7);
+        assert(Ecs_Get<PrefabLoot const>(world, entity)->items == (std::vector<int> { 1, 2, 3 }));
+    }
+
+    // Instances are independent of each other and of the prefab.
+    Ecs_Get<PrefabLoot>(world, wave[0])->items.push_back(4);
+    assert(Ecs_Get<PrefabLoot const>(world, wave[1])->items.size() == 3);
+    assert(Cast(PrefabLoot*, prefab.values[Ecs_TypeId<PrefabLoot>()])->items.size() == 3);
+
+    // Every new entity is marked as changed.
+    uint32 tick = Ecs_AdvanceTick(world);
+    EcsPrefab_Instantiate(world, prefab, std::span(wave).first(10));
+    size_t changed = 0;
+    Ecs_ForEachChunk(world, prefab.mask, [&](EcsArchetype&, EcsChunk& chunk) {
+        changed += EcsChunk_ChangedSince(chunk, prefab.mask, tick) ? 1 : 0;
+    });
+    assert(changed == 1);
+
+    EcsPrefab_Clear(prefab);
+    assert(prefab.mask == EcsComponentMask());
+    assert(prefab.values[Ecs_TypeId<PrefabLoot>()] == nullptr);
+
+    printf("TEST ECS PREFAB complete.\n");
+}
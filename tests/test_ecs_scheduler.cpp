@@ -0,0 +1,159 @@
+#include "Base/ecs/ecs_scheduler.h"
+#include "Base/ecs/ecs_view.h"
+#include <cassert>
+#include <cstdio>
+#include <mutex>
+#include <vector>
+
+namespace
+{
+struct SchedPosition
+{
+    float x, y;
+};
+
+struct SchedVelocity
+{
+    float x, y;
+};
+
+struct Log
+{
+    std::mutex          mutex;
+    std::vector<uint32> order;
+    float               sum { 0.0f };
+
+    void
+    record(uint32 system)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        order.push_back(system);
+    }
+
+    size_t
+    position_of(uint32 system) const
+    {
+        for (size_t i = 0; i < order.size(); ++i)
+        {
+            if (order[i] == system)
+            {
+                return i;
+            }
+        }
+        return order.size();
+    }
+};
+
+Log* log_for_run = nullptr;
+
+void
+SetPositions(EcsWorld& world, float, void*)
+{
+    log_for_run->record(0);
+    Ecs_Each<SchedPosition>(world, [](SchedPosition& p) { p = { 1.0f, 1.0f }; });
+}
+
+void
+SumPositions(EcsWorld& world, float, void* context)
+{
+    log_for_run->record(1);
+    float sum = 0.0f;
+    Ecs_Each<SchedPosition const>(world, [&](SchedPosition const& p) { sum += p.x; });
+    Cast(Log*, context)->sum = sum;
+}
+
+void
+SetVelocities(EcsWorld& world, float, void*)
+{
+    log_for_run->record(2);
+    Ecs_Each<SchedVelocity>(world, [](SchedVelocity& v) { v = { 2.0f, 2.0f }; });
+}
+
+void
+Integrate(EcsWorld& world, float dt, void*)
+{
+    log_for_run->record(3);
+    static EcsView<SchedPosition, SchedVelocity const> view;
+    view.each(world, [dt](SchedPosition& p, SchedVelocity const& v) {
+        p.x += v.x * dt;
+        p.y += v.y * dt;
+    });
+}
+} // namespace
+
+
+void
+Test_EcsScheduler()
+{
+    auto reader = EcsSystem_Make<SchedPosition const>("reader", &SumPositions);
+    auto writer = EcsSystem_Make<SchedPosition>("writer", &SetPositions);
+    auto other  = EcsSystem_Make<SchedVelocity>("other", &SetVelocities);
+    auto whole  = EcsSystem_MakeExclusive("whole", &SetVelocities);
+
+    assert(!EcsSystem_Conflicts(reader, reader));
+    assert(EcsSystem_Conflicts(reader, writer));
+    assert(EcsSystem_Conflicts(writer, reader));
+    assert(EcsSystem_Conflicts(writer, writer));
+    assert(!EcsSystem_Conflicts(writer, other));
+    assert(EcsSystem_Conflicts(whole, reader));
+
+    using IntegrateView = EcsView<SchedPosition, SchedVelocity const>;
+    assert(IntegrateView::reads() == Ecs_Mask<SchedVelocity>());
+    assert(IntegrateView::writes() == Ecs_Mask<SchedPosition>());
+
+    EcsWorld world;
+    for (int i = 0; i < 1000; ++i)
+    {
+        Ecs_Create(world, Ecs_Mask<SchedPosition, SchedVelocity>());
+    }
+
+    Log log;
+    log_for_run = &log;
+
+    EcsScheduler scheduler;
+    EcsScheduler_Add(scheduler, writer);
+    EcsScheduler_Add(scheduler, EcsSystem_Make<SchedPosition const>("reader", &SumPositions, &log));
+    EcsScheduler_Add(scheduler, other);
+    EcsScheduler_Add(scheduler,
+                     { "integrate",
+                       &Integrate,
+                       nullptr,
+                       IntegrateView::reads(),
+                       IntegrateView::writes(),
+                       false });
+    EcsScheduler_Build(scheduler);
+
+    // integrate waits for the writer, the reader and the velocities, the
+    // velocities wait for nothing.
+    assert(scheduler.dependency_counts[0] == 0);
+    assert(scheduler.dependency_counts[1] == 1);
+    assert(scheduler.dependency_counts[2] == 0);
+    assert(scheduler.dependency_counts[3] == 3);
+
+    // Serially the systems run in the order they were added.
+    EcsScheduler_Run(scheduler, world, 0.5f);
+    assert((log.order == std::vector<uint32> { 0, 1, 2, 3 }));
+    assert(log.sum == 1000.0f);
+
+    WorkerPool pool;
+    WorkerPool_Init(pool, 3);
+    for (int run = 0; run < 200; ++run)
+    {
+        log.order.clear();
+        log.sum = 0.0f;
+        EcsScheduler_Run(scheduler, world, 0.5f, &pool);
+
+        assert(log.order.size() == 4);
+        assert(log.position_of(0) < log.position_of(1));
+        assert(log.position_of(1) < log.position_of(3));
+        assert(log.position_of(2) < log.position_of(3));
+        assert(log.sum == 1000.0f);
+
+        Ecs_Each<SchedPosition const>(world, [](SchedPosition const& p) {
+            assert(p.x == 2.0f && p.y == 2.0f);
+        });
+    }
+
+    log_for_run = nullptr;
+    printf("TEST ECSSCHEDULER complete.\n");
+}
@@ -0,0 +1,120 @@
+#include "Base/ecs/ecs_snapshot.h"
+#include <cassert>
+#include <cstdio>
+#include <vector>
+
+namespace
+{
+struct SnapPosition
+{
+    float x, y;
+};
+
+struct SnapVelocity
+{
+    float x, y;
+};
+
+// Not trivially copyable, so it goes through EcsComponentInfo::copy.
+struct SnapPath
+{
+    std::vector<int> points;
+};
+
+// A tick of a toy simulation, which should come out the same when replayed.
+void
+Step(EcsWorld& world)
+{
+    Ecs_Each<SnapPosition, SnapVelocity const>(world, [](SnapPosition& p, SnapVelocity const& v) {
+        p.x += v.x;
+        p.y += v.y;
+    });
+    Ecs_Each<SnapPosition const, SnapPath>(world, [](SnapPosition const& p, SnapPath& path) {
+        path.points.push_back(Cast(int, p.x));
+    });
+}
+} // namespace
+
+
+void
+Test_EcsSnapshot()
+{
+    EcsWorld world;
+
+    std::vector<EcsEntity> entities;
+    for (int i = 0; i < 1000; ++i)
+    {
+        auto mask   = (i % 3) == 0 ? Ecs_Mask<SnapPosition, SnapVelocity, SnapPath>()
+                                   : Ecs_Mask<SnapPosition, SnapVelocity>();
+        auto entity = Ecs_Create(world, mask);
+        *Ecs_Get<SnapPosition>(world, entity) = { Cast(float, i), 0.0f };
+        *Ecs_Get<SnapVelocity>(world, entity) = { 1.0f, Cast(float, i % 7) };
+        entities.push_back(entity);
+    }
+
+    EcsSnapshot snapshot;
+    Ecs_SaveSnapshot(world, snapshot);
+
+    // Change values, handles and archetypes, then put them all back.
+    Step(world);
+    Ecs_Destroy(world, entities[1]);
+    Ecs_Remove<SnapVelocity>(world, entities[2]);
+    EcsEntity created = Ecs_Create(world, Ecs_Mask<SnapPosition>());
+    assert(Ecs_Get<SnapPath>(world, entities[0])->points.size() == 1);
+
+    Ecs_LoadSnapshot(world, snapshot);
+    assert(Ecs_EntityCount(world) == 1000);
+    assert(Ecs_IsAlive(world, entities[1]));
+    assert(Ecs_Has<SnapVelocity>(world, entities[2]));
+    assert(!Ecs_IsAlive(world, created));
+    for (int i = 0; i < 1000; ++i)
+    {
+        auto const* p = Ecs_Get<SnapPosition const>(world, entities[i]);
+        assert(p->x == Cast(float, i) && p->y == 0.0f);
+        assert(Ecs_Get<SnapVelocity const>(world, entities[i])->y == Cast(float, i % 7));
+    }
+    assert(Ecs_Get<SnapPath>(world, entities[0])->points.empty());
+
+    // The snapshot is still intact after loading, and handles made after the
+    // load don't collide with the restored ones.
+    Ecs_LoadSnapshot(world, snapshot);
+    assert(Ecs_EntityCount(world) == 1000);
+    EcsEntity fresh = Ecs_Create(world, Ecs_Mask<SnapPosition>());
+    for (auto entity : entities)
+    {
+        assert(!(entity == fresh));
+    }
+    Ecs_Destroy(world, fresh);
+
+    // The ring keeps the last few ticks and overwrites the oldest.
+    EcsSnapshotRing ring;
+    EcsSnapshotRing_Init(ring, 4);
+    std::vector<float> expected;
+    for (uint64 tick = 0; tick < 10; ++tick)
+    {
+        EcsSnapshotRing_Save(ring, world, tick);
+        expected.push_back(Ecs_Get<SnapPosition const>(world, entities[3])->y);
+        Step(world);
+    }
+    assert(EcsSnapshotRing_Find(ring, 5) == nullptr);
+    assert(EcsSnapshotRing_Find(ring, 6) != nullptr);
+    assert(EcsSnapshotRing_Find(ring, 9) != nullptr);
+    assert(EcsSnapshotRing_Find(ring, 10) == nullptr);
+
+    // Rolling back and re-simulating comes out exactly where it was.
+    float x    = Ecs_Get<SnapPosition const>(world, entities[6])->x;
+    float y    = Ecs_Get<SnapPosition const>(world, entities[6])->y;
+    auto  path = Ecs_Get<SnapPath const>(world, entities[6])->points;
+
+    Ecs_LoadSnapshot(world, *EcsSnapshotRing_Find(ring, 7));
+    assert(Ecs_Get<SnapPosition const>(world, entities[3])->y == expected[7]);
+    for (uint64 tick = 7; tick < 10; ++tick)
+    {
+        Step(world);
+    }
+    assert(Ecs_Get<SnapPosition const>(world, entities[6])->x == x);
+    assert(Ecs_Get<SnapPosition const>(world, entities[6])->y == y);
+    assert(Ecs_Get<SnapPath const>(world, entities[6])->points == path);
+
+    printf("TEST ECS SNAPSHOT complete.\n");
+}
@@ -0,0 +1,153 @@
+#include "Base/ecs/ecs_tick_rate.h"
+#include "Base/kernels/movement.h"
+#include <cassert>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+namespace
+{
+struct RatePosition
+{
+    float x;
+};
+
+struct RateSpeed
+{
+    float value;
+};
+
+struct RatePoint
+{
+    float x, y;
+};
+
+struct RateVelocity
+{
+    float x, y;
+};
+
+void
+SlowestPriority(EcsWorld&, EcsArchetype const&, EcsChunk&, std::span<uint8> levels, void*)
+{
+    std::fill(levels.begin(), levels.end(), Cast(uint8, ECS_TICK_RATE_LEVELS - 1));
+}
+
+// Level by distance from the origin, one level per 100 units.
+void
+Priority(EcsWorld&, EcsArchetype const& archetype, EcsChunk& chunk, std::span<uint8> levels, void*)
+{
+    auto positions = EcsChunk_Column<RatePosition>(archetype, chunk);
+    for (uint32 row = 0; row < chunk.count; ++row)
+    {
+        levels[row] = Cast(uint8, std::min(Cast(int, std::fabs(positions[row].x) / 100.0f), 3));
+    }
+}
+} // namespace
+
+
+void
+Test_EcsTickRate()
+{
+    // Only level 0 runs on every step, and every level runs on a sync step.
+    for (uint64 step = 0; step < 32; ++step)
+    {
+        assert(EcsTickRate_Due(step, 0));
+        assert(EcsTickRate_Due(step, 1) == ((step % 2) == 0));
+        assert(EcsTickRate_Due(step, 3) == ((step % 8) == 0));
+        assert(EcsTickRate_IsSync(step) == ((step % 8) == 0));
+    }
+    assert(EcsTickRate_Alpha(5, 0, 0.25f, 1.0f) == 0.25f);
+    assert(EcsTickRate_Alpha(5, 2, 0.0f, 1.0f) == 0.0f);
+    assert(EcsTickRate_Alpha(7, 2, 0.5f, 1.0f) == 2.5f / 4.0f);
+
+    EcsWorld     world;
+    EcsTickRates rates;
+
+    std::vector<EcsEntity> entities(400);
+    Ecs_CreateMany(world, Ecs_Mask<RatePosition, RateSpeed>(), entities);
+    for (size_t i = 0; i < entities.size(); ++i)
+    {
+        Ecs_Get<RatePosition>(world, entities[i])->x = Cast(float, i);
+        Ecs_Get<RateSpeed>(world, entities[i])->value = 1.0f;
+    }
+
+    EcsTickRates_Assign(rates, world, Ecs_Mask<RatePosition>(), &Priority, nullptr);
+    assert(Ecs_EntityCount(world) == 400);
+    for (size_t i = 0; i < entities.size(); ++i)
+    {
+        assert(EcsTickRate_EntityLevel(world, entities[i]) == i / 100);
+    }
+
+    // Whatever its level, every entity covers the same distance by a sync step.
+    static auto views = EcsTickRate_MakeViews<RatePosition, RateSpeed const>();
+    for (uint64 step = 0; step < 16; ++step)
+    {
+        for (uint32 level = 0; level < ECS_TICK_RATE_LEVELS; ++level)
+        {
+            if (EcsTickRate_Due(step, level))
+            {
+                float dt = Cast(float, EcsTickRate_Period(level));
+                views[level].each(world, [dt](RatePosition& p, RateSpeed const& s) {
+                    p.x += s.value * dt;
+                });
+            }
+        }
+    }
+    for (size_t i = 0; i < entities.size(); ++i)
+    {
+        assert(Ecs_Get<RatePosition const>(world, entities[i])->x == Cast(float, i) + 16.0f);
+    }
+
+    // Moving closer brings an entity back to full rate.
+    Ecs_Get<RatePosition>(world, entities[399])->x = 0.0f;
+    EcsTickRates_Assign(rates, world, Ecs_Mask<RatePosition>(), &Priority, nullptr);
+    assert(EcsTickRate_EntityLevel(world, entities[399]) == 0);
+    assert(Ecs_Get<RateSpeed const>(world, entities[399])->value == 1.0f);
+    assert(EcsTickRate_EntityLevel(world, entities[398]) == 3);
+
+    // Friction covering a whole period at once stops a slow entity, rather
+    // than turning it around.
+    {
+        EcsWorld  slow_world;
+        EcsEntity entity = Ecs_Create(slow_world, Ecs_Mask<RatePoint, RateVelocity>());
+        *Ecs_Get<RateVelocity>(slow_world, entity) = { 1.0f, 0.0f };
+        EcsTickRates_Assign(rates, slow_world, {}, &SlowestPriority, nullptr);
+        assert(EcsTickRate_EntityLevel(slow_world, entity) == 3);
+
+        static auto    move_views = EcsTickRate_MakeViews<RatePoint, RateVelocity>();
+        MovementParams step { 0.1f, 0.01f, 1.0f, 1.0f };
+        assert(Movement_ParamsForSteps(step, 1).friction == step.friction);
+
+        float last_x = 0.0f;
+        for (uint64 tick = 0; tick < 64; ++tick)
+        {
+            for (uint32 level = 0; level < ECS_TICK_RATE_LEVELS; ++level)
+            {
+                if (!EcsTickRate_Due(tick, level))
+                {
+                    continue;
+                }
+                auto params = Movement_ParamsForSteps(step, EcsTickRate_Period(level));
+                move_views[level].each_chunk(slow_world,
+                                             [&](EcsChunk&               chunk,
+                                                 std::span<RatePoint>     positions,
+                                                 std::span<RateVelocity> velocities) {
+                                                 Movement_Integrate(&positions[0].x,
+                                                                    &velocities[0].x,
+                                                                    chunk.count,
+                                                                    params);
+                                             });
+            }
+
+            auto const* velocity = Ecs_Get<RateVelocity const>(slow_world, entity);
+            auto const* position = Ecs_Get<RatePoint const>(slow_world, entity);
+            assert(velocity->x >= 0.0f && position->x >= last_x);
+            last_x = position->x;
+        }
+        assert(Ecs_Get<RateVelocity const>(slow_world, entity)->x == 0.0f);
+    }
+
+    printf("TEST ECS TICK RATE complete.\n");
+}
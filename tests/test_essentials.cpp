@@ -16,6 +16,66 @@ Test_VirtualMemory();
 extern void
 Test_RelativePointers();
 
+extern void
+Test_BitSet();
+
+extern void
+Test_FixedMap();
+
+extern void
+Test_SmallVector();
+
+extern void
+Test_SoaArray();
+
+extern void
+Test_SlotMap();
+
+extern void
+Test_VirtualVector();
+
+extern void
+Test_SparseSet();
+
+extern void
+Test_Ecs();
+
+extern void
+Test_Movement();
+
+extern void
+Test_WorkerPool();
+
+extern void
+Test_EcsScheduler();
+
+extern void
+Test_EcsCommands();
+
+extern void
+Test_EcsDispatch();
+
+extern void
+Test_Animation();
+
+extern void
+Test_SpatialGrid();
+
+extern void
+Test_Collision();
+
+extern void
+Test_EcsSnapshot();
+
+extern void
+Test_EcsFile();
+
+extern void
+Test_EcsPrefab();
+
+extern void
+Test_EcsTickRate();
+
 int
 main()
 {
@@ -25,4 +85,24 @@ main()
     Test_VirtualMemory();
     Test_DebugServices();
     Test_RelativePointers();
+    Test_BitSet();
+    Test_FixedMap();
+    Test_SmallVector();
+    Test_SoaArray();
+    Test_SlotMap();
+    Test_VirtualVector();
+    Test_SparseSet();
+    Test_Ecs();
+    Test_Movement();
+    Test_WorkerPool();
+    Test_EcsScheduler();
+    Test_EcsCommands();
+    Test_EcsDispatch();
+    Test_Animation();
+    Test_SpatialGrid();
+    Test_Collision();
+    Test_EcsSnapshot();
+    Test_EcsFile();
+    Test_EcsPrefab();
+    Test_EcsTickRate();
 }
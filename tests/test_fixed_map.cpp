@@ -0,0 +1,100 @@
+#include "Base/containers/fixed_map.h"
+#include <cassert>
+#include <cstdio>
+#include <map>
+
+void
+Test_FixedMapBasics()
+{
+    FixedMap<Int, float, 16> map;
+
+    assert(map.empty());
+    assert(map.capacity() == 14);
+    assert(map.find(1) == nullptr);
+
+    // insert returns a pointer to the value which can be written through.
+    *map.insert(1) = 1.0f;
+    map.insert(2, 2.0f);
+    map[3] = 3.0f;
+
+    assert(map.size() == 3);
+    assert(*map.find(1) == 1.0f);
+    assert(*map.find(2) == 2.0f);
+    assert(map[3] == 3.0f);
+    assert(map.contains(2));
+    assert(!map.contains(4));
+
+    // Inserting an existing key returns the existing value.
+    assert(*map.insert(1) == 1.0f);
+    assert(map.size() == 3);
+
+    float sum = 0;
+    for (auto const& item : map)
+    {
+        sum += item.second;
+    }
+    assert(sum == 6.0f);
+
+    assert(map.erase(2));
+    assert(!map.erase(2));
+    assert(!map.contains(2));
+    assert(map.size() == 2);
+
+    // Once full, new keys are rejected but existing keys can still be found.
+    for (Int key = 10; !map.full(); ++key)
+    {
+        assert(map.insert(key) != nullptr);
+    }
+    assert(map.insert(1000) == nullptr);
+    assert(map.find(1) != nullptr);
+
+    map.clear();
+    assert(map.empty());
+    assert(map.begin() == map.end());
+}
+
+void
+Test_FixedMapMatchesStdMap()
+{
+    // Mix inserts and erases and compare against std::map. Erase shifts
+    // entries back rather than leaving tombstones, so lookups must still find
+    // every entry in a cluster after the ones in front of it are removed.
+    FixedMap<uint32, uint32, 256> map;
+    std::map<uint32, uint32>      reference;
+
+    uint32 seed = 12345;
+    for (int step = 0; step < 20000; ++step)
+    {
+        seed       = seed * 1664525u + 1013904223u;
+        uint32 key = (seed >> 8) % 300;
+
+        if ((seed & 3) == 0)
+        {
+            assert(map.erase(key) == (reference.erase(key) == 1));
+        }
+        else if (!map.full() || map.contains(key))
+        {
+            map.insert(key, step);
+            reference[key] = step;
+        }
+
+        assert(map.size() == reference.size());
+    }
+
+    for (auto const& [key, value] : reference)
+    {
+        assert(*map.find(key) == value);
+    }
+    for (auto const& item : map)
+    {
+        assert(reference.at(item.first) == item.second);
+    }
+}
+
+void
+Test_FixedMap()
+{
+    Test_FixedMapBasics();
+    Test_FixedMapMatchesStdMap();
+    printf("TEST FIXEDMAP complete.\n");
+}
@@ -0,0 +1,92 @@
+#include "Base/kernels/movement.h"
+#include "Base/platform/platform.h"
+#include <cassert>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+
+// Odd so every SIMD kernel has a scalar tail.
+constexpr size_t MOVEMENT_TEST_COUNT = 1027;
+
+static void
+Movement_RandomState(std::vector<float>& positions, std::vector<float>& velocities)
+{
+    std::mt19937                          rng(1234);
+    std::uniform_real_distribution<float> dist(-2.0f, 2.0f);
+
+    positions.resize(MOVEMENT_TEST_COUNT * 2);
+    velocities.resize(MOVEMENT_TEST_COUNT * 2);
+    for (size_t i = 0; i < positions.size(); ++i)
+    {
+        positions[i]  = dist(rng) * 100.0f;
+        velocities[i] = dist(rng);
+    }
+
+    // Stopped, and only just moving, entities.
+    velocities[0] = 0.0f;
+    velocities[1] = 0.0f;
+    velocities[2] = 0.005f;
+    velocities[3] = 0.0f;
+}
+
+static bool
+Movement_BitwiseEqual(std::vector<float> const& a, std::vector<float> const& b)
+{
+    return a.size() == b.size() && std::memcmp(a.data(), b.data(), a.size() * sizeof(float)) == 0;
+}
+
+void
+Test_Movement()
+{
+    MovementParams params { 0.1f, 0.01f, 300.0f, 1.0f / 60.0f };
+
+    std::vector<float> positions, velocities;
+    Movement_RandomState(positions, velocities);
+
+    // Scalar reference, run for a few steps so friction brings some entities to a stop.
+    std::vector<float> expected_p = positions, expected_v = velocities;
+    for (int step = 0; step < 8; ++step)
+    {
+        Movement_IntegrateScalar(expected_p.data(), expected_v.data(), MOVEMENT_TEST_COUNT, params);
+    }
+    assert(expected_v[0] == 0.0f && expected_v[1] == 0.0f);
+    assert(expected_v[2] == 0.0f && expected_v[3] == 0.0f);
+
+    auto check_deterministic = [&](MovementKernel kernel) {
+        std::vector<float> p = positions, v = velocities;
+        for (int step = 0; step < 8; ++step)
+        {
+            kernel(p.data(), v.data(), MOVEMENT_TEST_COUNT, params);
+        }
+        assert(Movement_BitwiseEqual(p, expected_p));
+        assert(Movement_BitwiseEqual(v, expected_v));
+    };
+
+    check_deterministic(Movement_SelectKernel(MovementMode::Deterministic));
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64)
+    check_deterministic(Movement_IntegrateSse2);
+    if (Platform_CpuHasAvx2())
+    {
+        check_deterministic(Movement_IntegrateAvx2);
+    }
+#endif
+
+    // Fast mode only has to be close.
+    std::vector<float> p = positions, v = velocities;
+    for (int step = 0; step < 8; ++step)
+    {
+        Movement_Integrate(p.data(), v.data(), MOVEMENT_TEST_COUNT, params, MovementMode::Fast);
+    }
+    for (size_t i = 0; i < p.size(); ++i)
+    {
+        assert(std::fabs(v[i] - expected_v[i]) <= 1e-4f);
+        assert(std::fabs(p[i] - expected_p[i]) <= 1e-2f);
+    }
+
+    // Nothing to do.
+    Movement_Integrate(nullptr, nullptr, 0, params);
+
+    printf("TEST MOVEMENT complete.\n");
+}
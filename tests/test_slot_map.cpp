@@ -0,0 +1,61 @@
+#include "Base/containers/slot_map.h"
+#include <cassert>
+#include <cstdio>
+
+void
+Test_SlotMap()
+{
+    SlotMap<int> map;
+    assert(map.empty());
+
+    auto a = map.insert(1);
+    auto b = map.insert(2);
+    auto c = map.insert(3);
+    assert(map.size() == 3);
+
+    assert(*map.get(a) == 1);
+    assert(*map.get(b) == 2);
+    assert(*map.get(c) == 3);
+
+    // Erasing keeps the storage dense by moving the back element into the hole,
+    // handles to the moved element still resolve.
+    assert(map.erase(a));
+    assert(map.size() == 2);
+    assert(map.get(a) == nullptr);
+    assert(!map.contains(a));
+    assert(*map.get(c) == 3);
+    assert(map[0] == 3);
+
+    // Erasing twice is detected.
+    assert(!map.erase(a));
+
+    // The freed slot is reused, but the stale handle stays invalid.
+    auto d = map.insert(4);
+    assert(d.index == a.index);
+    assert(d.generation != a.generation);
+    assert(map.get(a) == nullptr);
+    assert(*map.get(d) == 4);
+
+    // handle_at maps dense positions back to handles.
+    for (size_t i = 0; i < map.size(); ++i)
+    {
+        assert(*map.get(map.handle_at(i)) == map[i]);
+    }
+
+    int sum = 0;
+    for (auto value : map)
+    {
+        sum += value;
+    }
+    assert(sum == 9);
+
+    // Handles that were never issued don't resolve.
+    assert(map.get(SLOT_HANDLE_INVALID) == nullptr);
+
+    map.clear();
+    assert(map.empty());
+    assert(map.get(b) == nullptr);
+    assert(map.get(d) == nullptr);
+
+    printf("TEST SLOTMAP complete.\n");
+}
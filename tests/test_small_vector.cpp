@@ -0,0 +1,105 @@
+#include "Base/arena.h"
+#include "Base/containers/small_vector.h"
+#include <cassert>
+#include <cstdio>
+
+void
+Test_SmallVectorInline()
+{
+    SmallVector<int, 4> data;
+
+    assert(data.empty());
+    assert(data.capacity() == 4);
+    assert(data.is_inline());
+
+    // Same interface as Array.
+    assert(data.push_back(1));
+    assert(data.push_back(2));
+    assert(data.push_back(3));
+    assert(data.size() == 3);
+    assert(data.back() == 3);
+
+    assert(data.pop_front(0) == 1);
+    assert(data.size() == 2);
+    assert(data[0] == 2);
+    assert(data[1] == 3);
+
+    data.clear();
+    assert(data.pop_front(-1) == -1);
+    assert(data.is_inline());
+}
+
+void
+Test_SmallVectorSpills()
+{
+    SmallVector<int, 4> data;
+    for (int i = 0; i < 10; ++i)
+    {
+        data.push_back(i);
+    }
+
+    // Growing past Nm moves the elements out of line.
+    assert(!data.is_inline());
+    assert(data.size() == 10);
+    assert(data.capacity() >= 10);
+
+    int test_value = 0;
+    for (auto value : data)
+    {
+        assert(value == test_value);
+        test_value += 1;
+    }
+
+    // Copies are deep, moves steal the spilled storage.
+    auto copy = data;
+    assert(copy.size() == 10);
+    assert(copy.begin() != data.begin());
+
+    auto* storage = data.begin();
+    auto  moved   = std::move(data);
+    assert(moved.begin() == storage);
+    assert(data.empty());
+    assert(data.is_inline());
+
+    // reserve value initialises the new elements.
+    SmallVector<int, 2> zeros;
+    assert(zeros.reserve(5));
+    assert(zeros.size() == 5);
+    for (auto value : zeros)
+    {
+        assert(value == 0);
+    }
+}
+
+void
+Test_SmallVectorArena()
+{
+    auto arena = Arena_Make(Kilobytes(4));
+
+    {
+        SmallVector<float, 2, ArenaAllocator<float>> data { ArenaAllocator<float>(&arena) };
+        data.push_back(1.0f);
+        data.push_back(2.0f);
+        assert(arena.used == 0);
+
+        data.push_back(3.0f);
+        assert(!data.is_inline());
+        assert(arena.used > 0);
+
+        // The spilled storage comes from the arena.
+        auto* first = (UByte*)data.begin();
+        assert(first >= arena.base && first < arena.base + arena.size);
+        assert(data[2] == 3.0f);
+    }
+
+    Arena_Free(arena);
+}
+
+void
+Test_SmallVector()
+{
+    Test_SmallVectorInline();
+    Test_SmallVectorSpills();
+    Test_SmallVectorArena();
+    printf("TEST SMALLVECTOR complete.\n");
+}
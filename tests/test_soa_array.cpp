@@ -0,0 +1,72 @@
+#include "Base/containers/soa_array.h"
+#include <cassert>
+#include <cstdint>
+#include <cstdio>
+
+enum TestField
+{
+    Test_X,
+    Test_Y,
+    Test_Id,
+};
+
+void
+Test_SoaArray()
+{
+    SoaArray<8, float, float, int> data;
+
+    assert(data.empty());
+    assert(data.capacity() == 8);
+
+    // Each field lives in its own aligned column.
+    assert(((uintptr_t)data.data<Test_X>() % 64) == 0);
+    assert(((uintptr_t)data.data<Test_Y>() % 64) == 0);
+    assert(((uintptr_t)data.data<Test_Id>() % 64) == 0);
+
+    assert(data.push_back(1.0f, 10.0f, 1));
+    assert(data.push_back(2.0f, 20.0f, 2));
+    assert(data.push_back(3.0f, 30.0f, 3));
+    assert(data.size() == 3);
+
+    // Columns span the reserved elements.
+    auto xs = data.column<Test_X>();
+    assert(xs.size() == 3);
+    assert(xs[1] == 2.0f);
+
+    // Rows give access to every field of one element.
+    auto row = data[2];
+    assert(row.get<Test_Y>() == 30.0f);
+    row.get<Test_Id>() = 42;
+    assert(data.column<Test_Id>()[2] == 42);
+
+    // Structured bindings are references into the columns.
+    {
+        auto [x, y, id] = data[0];
+        x += 0.5f;
+        (void)y;
+        (void)id;
+    }
+    assert(data.column<Test_X>()[0] == 1.5f);
+
+    float sum = 0;
+    for (auto [x, y, id] : data)
+    {
+        sum += y;
+        (void)x;
+        (void)id;
+    }
+    assert(sum == 60.0f);
+    assert(data.end() - data.begin() == 3);
+
+    // remove_swap moves the last element into the removed slot.
+    data.remove_swap(0);
+    assert(data.size() == 2);
+    assert(data.column<Test_Id>()[0] == 42);
+    assert(data.column<Test_X>()[0] == 3.0f);
+
+    assert(data.reserve(6));
+    assert(data.full());
+    assert(!data.push_back(0, 0, 0));
+
+    printf("TEST SOAARRAY complete.\n");
+}
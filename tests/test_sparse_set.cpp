@@ -0,0 +1,59 @@
+#include "Base/containers/sparse_set.h"
+#include <cassert>
+#include <cstdio>
+
+void
+Test_SparseSet()
+{
+    SparseSet<int> set;
+    assert(set.empty());
+
+    set.insert(7, 70);
+    set.insert(2, 20);
+    set.insert(40, 400);
+    assert(set.size() == 3);
+
+    assert(set.contains(7));
+    assert(!set.contains(3));
+    assert(!set.contains(1000));
+    assert(*set.get(2) == 20);
+    assert(set.get(3) == nullptr);
+
+    // Inserting an existing key replaces its value.
+    set.insert(2, 21);
+    assert(set.size() == 3);
+    assert(*set.get(2) == 21);
+
+    // Erasing moves the back value into the hole and patches its key.
+    assert(set.erase(7));
+    assert(!set.erase(7));
+    assert(set.size() == 2);
+    assert(set[0] == 400);
+    assert(set.key_at(0) == 40);
+    assert(*set.get(40) == 400);
+    assert(*set.get(2) == 21);
+
+    // keys and values stay in step.
+    for (size_t i = 0; i < set.size(); ++i)
+    {
+        assert(*set.get(set.keys()[i]) == set[i]);
+    }
+
+    int sum = 0;
+    for (auto value : set)
+    {
+        sum += value;
+    }
+    assert(sum == 421);
+
+    set.clear();
+    assert(set.empty());
+    assert(!set.contains(2));
+    assert(!set.contains(40));
+
+    set.reserve(8, 64);
+    set.insert(63, 1);
+    assert(*set.get(63) == 1);
+
+    printf("TEST SPARSESET complete.\n");
+}
@@ -0,0 +1,146 @@
+#include "Base/spatial_grid.h"
+#include <algorithm>
+#include <cassert>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+constexpr uint32 SPATIAL_TEST_COUNT = 2000;
+
+static std::vector<SpatialBox>
+Spatial_RandomBoxes(std::mt19937& rng)
+{
+    std::uniform_real_distribution<float> position(-500.0f, 500.0f);
+    std::uniform_real_distribution<float> size(1.0f, 30.0f);
+
+    std::vector<SpatialBox> boxes;
+    for (uint32 i = 0; i < SPATIAL_TEST_COUNT; ++i)
+    {
+        float x = position(rng), y = position(rng);
+        boxes.push_back({ x, y, x + size(rng), y + size(rng) });
+    }
+    // One much larger than a cell.
+    boxes[7] = { -100.0f, -100.0f, 100.0f, 100.0f };
+    return boxes;
+}
+
+static std::vector<SpatialPair>
+Spatial_BruteForcePairs(std::vector<SpatialBox> const& boxes, std::vector<bool> const& present)
+{
+    std::vector<SpatialPair> pairs;
+    for (uint32 a = 0; a < boxes.size(); ++a)
+    {
+        for (uint32 b = a + 1; b < boxes.size(); ++b)
+        {
+            if (present[a] && present[b] && SpatialBox_Overlaps(boxes[a], boxes[b]))
+            {
+                pairs.push_back({ a, b });
+            }
+        }
+    }
+    return pairs;
+}
+
+static void
+Spatial_CheckAgainstBruteForce(SpatialGrid&                   grid,
+                               std::vector<SpatialBox> const& boxes,
+                               std::vector<bool> const&       present)
+{
+    std::vector<SpatialPair> pairs;
+    size_t                   n = SpatialGrid_Pairs(grid, pairs);
+    assert(n == pairs.size());
+    std::sort(pairs.begin(), pairs.end());
+    assert(pairs == Spatial_BruteForcePairs(boxes, present));
+
+    // Candidates are each pair sharing a cell once, which every overlapping pair does.
+    std::vector<SpatialPair> candidates;
+    SpatialGrid_Candidates(grid, candidates);
+    std::sort(candidates.begin(), candidates.end());
+    assert(std::adjacent_find(candidates.begin(), candidates.end()) == candidates.end());
+    assert(std::includes(candidates.begin(), candidates.end(), pairs.begin(), pairs.end()));
+    for (auto [a, b] : candidates)
+    {
+        SpatialCells const& ca = grid.cells[a];
+        SpatialCells const& cb = grid.cells[b];
+        assert(a < b && ca.x0 <= cb.x1 && cb.x0 <= ca.x1 && ca.y0 <= cb.y1 && cb.y0 <= ca.y1);
+    }
+
+    SpatialBox const    view { -120.0f, -80.0f, 240.0f, 160.0f };
+    std::vector<uint32> visible;
+    SpatialGrid_Query(grid, view, visible);
+    std::sort(visible.begin(), visible.end());
+
+    std::vector<uint32> expected;
+    for (uint32 i = 0; i < boxes.size(); ++i)
+    {
+        if (present[i] && SpatialBox_Overlaps(boxes[i], view))
+        {
+            expected.push_back(i);
+        }
+    }
+    assert(visible == expected);
+}
+
+void
+Test_SpatialGrid()
+{
+    std::mt19937            rng(99);
+    std::vector<SpatialBox> boxes = Spatial_RandomBoxes(rng);
+    std::vector<bool>       present(boxes.size(), true);
+
+    // Few buckets, so cells share them.
+    SpatialGrid grid;
+    SpatialGrid_Init(grid, 32.0f, 256);
+    for (uint32 i = 0; i < boxes.size(); ++i)
+    {
+        SpatialGrid_Update(grid, i, boxes[i]);
+    }
+    assert(grid.ids.size() == boxes.size());
+    Spatial_CheckAgainstBruteForce(grid, boxes, present);
+
+    // Move everything a little, some across cells, and remove some.
+    std::uniform_real_distribution<float> nudge(-8.0f, 8.0f);
+    for (int tick = 0; tick < 4; ++tick)
+    {
+        for (uint32 i = 0; i < boxes.size(); ++i)
+        {
+            if (present[i])
+            {
+                SpatialBox& box = boxes[i];
+                float       dx = nudge(rng), dy = nudge(rng);
+                box = { box.min_x + dx, box.min_y + dy, box.max_x + dx, box.max_y + dy };
+                SpatialGrid_Update(grid, i, box);
+            }
+        }
+        for (uint32 i = tick; i < boxes.size(); i += 13)
+        {
+            SpatialGrid_Remove(grid, i);
+            present[i] = false;
+        }
+        Spatial_CheckAgainstBruteForce(grid, boxes, present);
+    }
+    assert(!SpatialGrid_Contains(grid, 0) && SpatialGrid_Contains(grid, 4));
+
+    // Every bucket only holds ids that are in the grid.
+    for (auto const& bucket : grid.buckets)
+    {
+        for (uint32 id : bucket)
+        {
+            assert(present[id]);
+        }
+    }
+
+    // Boxes touching along an edge don't overlap.
+    SpatialGrid_Clear(grid);
+    assert(grid.ids.empty() && !SpatialGrid_Contains(grid, 1));
+    SpatialGrid_Update(grid, 1, { 0.0f, 0.0f, 32.0f, 32.0f });
+    SpatialGrid_Update(grid, 2, { 32.0f, 0.0f, 64.0f, 32.0f });
+    SpatialGrid_Update(grid, 3, { 31.0f, 31.0f, 33.0f, 33.0f });
+
+    std::vector<SpatialPair> pairs;
+    SpatialGrid_Pairs(grid, pairs);
+    std::sort(pairs.begin(), pairs.end());
+    assert((pairs == std::vector<SpatialPair> { { 1, 3 }, { 2, 3 } }));
+
+    printf("TEST SPATIALGRID complete.\n");
+}
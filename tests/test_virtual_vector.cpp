@@ -0,0 +1,56 @@
+#include "Base/containers/virtual_vector.h"
+#include <cassert>
+#include <cstdio>
+
+void
+Test_VirtualVector()
+{
+    // Only address space is reserved up front.
+    VirtualVector<uint64> data(Megabytes(64));
+    assert(data.empty());
+    assert(data.committed_bytes == 0);
+    assert(data.capacity() == Megabytes(64) / sizeof(uint64));
+
+    assert(data.push_back(0));
+    uint64* first = &data[0];
+
+    // Grow well past the first commit, the existing elements never move.
+    for (uint64 i = 1; i < 100000; ++i)
+    {
+        assert(data.push_back(i));
+    }
+    assert(&data[0] == first);
+    assert(data.size() == 100000);
+    assert(data.committed_bytes >= sizeof(uint64) * 100000);
+    assert(data.committed_bytes < Megabytes(1));
+
+    uint64 expected = 0;
+    for (auto value : data)
+    {
+        assert(value == expected);
+        expected += 1;
+    }
+
+    // Array style reserve grows the size with value initialised elements.
+    assert(data.reserve(2));
+    assert(data.back() == 0);
+    data.pop_back();
+    data.pop_back();
+
+    data.remove_swap(0);
+    assert(data[0] == 99999);
+    assert(data.size() == 99999);
+
+    // Once the reservation is used up growth fails rather than moving.
+    VirtualVector<uint64> small(Kilobytes(64));
+    assert(small.reserve(small.capacity()));
+    assert(small.full());
+    assert(!small.push_back(1));
+
+    // Moves transfer the reservation.
+    auto moved = std::move(data);
+    assert(moved.size() == 99999);
+    assert(data.data() == nullptr);
+
+    printf("TEST VIRTUALVECTOR complete.\n");
+}
@@ -0,0 +1,81 @@
+#include "Base/worker_pool.h"
+#include <atomic>
+#include <cassert>
+#include <cstdio>
+
+namespace
+{
+struct Counter
+{
+    WorkerPool*         pool;
+    std::atomic<uint32> runs { 0 };
+    std::atomic<uint32> bad_thread_index { 0 };
+};
+
+void
+Count(void* data, uint32 thread_index)
+{
+    auto& counter = *static_cast<Counter*>(data);
+    if (thread_index >= WorkerPool_ThreadCount(*counter.pool))
+    {
+        counter.bad_thread_index += 1;
+    }
+    counter.runs += 1;
+}
+
+// Pushes two more Count jobs from inside a job.
+void
+Spawn(void* data, uint32 thread_index)
+{
+    auto& counter = *static_cast<Counter*>(data);
+    WorkerPool_Push(*counter.pool, { &Count, data });
+    WorkerPool_Push(*counter.pool, { &Count, data });
+    Count(data, thread_index);
+}
+} // namespace
+
+
+void
+Test_WorkerPool()
+{
+    {
+        WorkerPool pool;
+        WorkerPool_Init(pool, 3);
+        assert(WorkerPool_ThreadCount(pool) == 4);
+
+        Counter counter;
+        counter.pool = &pool;
+        for (int i = 0; i < 1000; ++i)
+        {
+            WorkerPool_Push(pool, { &Count, &counter });
+        }
+        WorkerPool_Wait(pool);
+        assert(counter.runs == 1000);
+
+        // Jobs pushed by jobs are waited for too.
+        counter.runs = 0;
+        for (int i = 0; i < 100; ++i)
+        {
+            WorkerPool_Push(pool, { &Spawn, &counter });
+        }
+        WorkerPool_Wait(pool);
+        assert(counter.runs == 300);
+        assert(counter.bad_thread_index == 0);
+    }
+
+    // Without workers everything runs on the waiting thread.
+    {
+        WorkerPool pool;
+        WorkerPool_Init(pool, 0);
+        assert(WorkerPool_ThreadCount(pool) == 1);
+
+        Counter counter;
+        counter.pool = &pool;
+        WorkerPool_Push(pool, { &Spawn, &counter });
+        assert(counter.runs == 0);
+        WorkerPool_Wait(pool);
+        assert(counter.runs == 3);
+    }
+
+    printf("TEST WORKERPOOL complete.\n");
+}